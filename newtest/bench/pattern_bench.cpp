@@ -0,0 +1,253 @@
+// 弹幕引擎和子弹池的基准测试 (不打开窗口，不依赖游戏的其他部分)。
+// 编译时只需加入上一级目录中的 bullet.cpp 和 pattern.cpp，例如：
+//     g++ -std=c++17 -O2 -I.. pattern_bench.cpp ../bullet.cpp ../pattern.cpp -lsfml-graphics -lsfml-window -lsfml-system
+// 用法：pattern_bench [--filter 名字] [--scale 倍数]，结果以 JSON 输出到标准输出，
+// 每个场景结束时的子弹数输出到标准错误。
+// 计时和 JSON 格式与 全部要求完成版/bench/bench.cpp 相同 (两个游戏是各自独立的项目，不共用代码)，改动时两边一起改
+#include "../bullet.h"
+#include "../pattern.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+// 统计堆分配次数 (替换全局 operator new)
+static std::atomic<unsigned long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 一个场景：setup 准备数据 (不计时)，op 执行一次被测操作
+struct Scenario {
+    std::string name;
+    int warmup;
+    int iterations;
+    std::function<void()> setup;
+    std::function<void()> op;
+};
+
+struct Result {
+    std::string name;
+    int ops;
+    double nsPerOp;
+    double allocsPerOp;
+    uint64_t p50;
+    uint64_t p95;
+    uint64_t p99;
+    uint64_t max;
+};
+
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static Result runScenario(const Scenario& scenario) {
+    scenario.setup();
+    for (int i = 0; i < scenario.warmup; ++i) {
+        scenario.op();
+    }
+
+    std::vector<uint64_t> samples;
+    samples.reserve(scenario.iterations);
+    unsigned long long allocationsBefore = allocationCount.load();
+    uint64_t total = 0;
+    for (int i = 0; i < scenario.iterations; ++i) {
+        uint64_t start = nowNs();
+        scenario.op();
+        uint64_t elapsed = nowNs() - start;
+        samples.push_back(elapsed);
+        total += elapsed;
+    }
+    // samples 已预留好空间，计时期间不会分配
+    unsigned long long allocations = allocationCount.load() - allocationsBefore;
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = scenario.name;
+    result.ops = scenario.iterations;
+    result.nsPerOp = static_cast<double>(total) / scenario.iterations;
+    result.allocsPerOp = static_cast<double>(allocations) / scenario.iterations;
+    result.p50 = percentile(samples, 0.50);
+    result.p95 = percentile(samples, 0.95);
+    result.p99 = percentile(samples, 0.99);
+    result.max = samples.back();
+    return result;
+}
+
+// 发射点：屏幕中心周围一圈
+static const int EMITTERS = 16;
+static const sf::Vector2f SCREEN_CENTER(SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f);
+
+static sf::Vector2f emitterPosition(int e) {
+    float angle = e * 6.2831853f / EMITTERS;
+    return SCREEN_CENTER + sf::Vector2f(200.f * std::cos(angle), 150.f * std::sin(angle));
+}
+
+static sf::Vector2f aimAt(const sf::Vector2f& from, const sf::Vector2f& to) {
+    sf::Vector2f d = to - from;
+    float length = std::sqrt(d.x * d.x + d.y * d.y);
+    return length > 0.f ? d / length : sf::Vector2f(1.f, 0.f);
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    int scale = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--filter") {
+            filter = argv[i + 1];
+        }
+        else if (arg == "--scale") {
+            scale = std::max(1, std::atoi(argv[i + 1]));
+        }
+    }
+
+    // 所有场景共用的子弹池和图案，每个场景的 setup 清空子弹池
+    BulletPool bullets;
+    PatternEngine patterns;
+    const sf::Color color(255, 0, 255);
+    unsigned frame = 0;
+    sf::Vector2f target = SCREEN_CENTER;
+
+    PatternDesc desc;
+    desc.shape = PatternShape::RING;
+    desc.count = 32;
+    desc.speed = 3.f;
+    desc.spinSteps = 36;
+    const uint8_t spiralRing = patterns.add(desc);
+
+    desc = PatternDesc();
+    desc.shape = PatternShape::FAN;
+    desc.count = 9;
+    desc.spread = 1.2f;
+    desc.speed = 4.f;
+    const uint8_t aimedFan = patterns.add(desc);
+
+    // 到期分裂：12发的环，40帧后每颗分裂成6发的环，再分裂一次，每代都活40帧。
+    // 每一代用自己的 child 找下一代的图案，最后一代也要指定 (默认的 0 是上面的旋转环形)
+    desc = PatternDesc();
+    desc.shape = PatternShape::RING;
+    desc.count = 6;
+    desc.speed = 2.5f;
+    desc.lifetime = 40;
+    const uint8_t splitLeaf = patterns.add(desc);
+    desc.child = splitLeaf;
+    const uint8_t splitChild = patterns.add(desc);
+    desc.count = 12;
+    desc.splitCount = 2;
+    desc.child = splitChild;
+    const uint8_t splitRing = patterns.add(desc);
+
+    desc = PatternDesc();
+    desc.shape = PatternShape::FAN;
+    desc.count = 8;
+    desc.spread = 3.f;
+    desc.speed = 3.f;
+    desc.lifetime = 180;
+    desc.homingTurn = 0.04f;
+    const uint8_t homingFan = patterns.add(desc);
+
+    auto reset = [&]() {
+        bullets.clear();
+        frame = 0;
+    };
+
+    // 每个逻辑帧：发射点轮流发射，然后引擎更新追踪/分裂子弹，子弹池移动并回收出界子弹
+    auto step = [&](uint8_t pattern, unsigned interval) {
+        for (int e = 0; e < EMITTERS; ++e) {
+            if ((frame + e) % interval == 0) {
+                sf::Vector2f origin = emitterPosition(e);
+                patterns.fire(pattern, bullets, origin, aimAt(origin, target), frame / interval, 1.f, color);
+            }
+        }
+        patterns.update(bullets, target);
+        bullets.update();
+        frame++;
+    };
+
+    std::vector<Scenario> scenarios;
+
+    // 16个发射点每4帧一轮32发的旋转环形弹幕 (稳定后约2万颗子弹)
+    scenarios.push_back(Scenario{ "spiral_ring", 300, 600 * scale, reset,
+        [&]() { step(spiralRing, 4); } });
+
+    // 每2帧一轮9发的瞄准扇形
+    scenarios.push_back(Scenario{ "aimed_fan", 300, 600 * scale, reset,
+        [&]() { step(aimedFan, 2); } });
+
+    // 同样的扇形，每颗子弹用三角函数算方向 (引擎之前的写法，用于对比)
+    scenarios.push_back(Scenario{ "aimed_fan_trig", 300, 600 * scale, reset,
+        [&]() {
+            for (int e = 0; e < EMITTERS; ++e) {
+                if ((frame + e) % 2 == 0) {
+                    sf::Vector2f origin = emitterPosition(e);
+                    float base = std::atan2(target.y - origin.y, target.x - origin.x);
+                    for (int k = 0; k < 9; ++k) {
+                        float angle = base - 0.6f + k * 0.15f;
+                        bullets.spawn(origin, sf::Vector2f(std::cos(angle), std::sin(angle)), 4.f, 1.f, color, true);
+                    }
+                }
+            }
+            bullets.update();
+            frame++;
+        } });
+
+    // 每帧一轮会分裂两次的环形弹幕 (一轮最多432颗，稳定后约2万颗子弹，不会占满子弹池)
+    scenarios.push_back(Scenario{ "split_on_expire", 300, 600 * scale, reset,
+        [&]() { step(splitRing, 16); } });
+
+    // 每4帧一轮追踪子弹，目标在屏幕上绕圈
+    scenarios.push_back(Scenario{ "homing_fan", 300, 600 * scale, reset,
+        [&]() {
+            float angle = frame * 0.02f;
+            target = SCREEN_CENTER + sf::Vector2f(250.f * std::cos(angle), 200.f * std::sin(angle));
+            step(homingFan, 4);
+        } });
+
+    std::vector<Result> results;
+    for (const Scenario& scenario : scenarios) {
+        if (filter.empty() || scenario.name.find(filter) != std::string::npos) {
+            results.push_back(runScenario(scenario));
+            // 子弹池占满时多出的子弹被丢弃，场景测到的就不是预期的负载
+            std::fprintf(stderr, "%s: %zu / %zu bullets\n", scenario.name.c_str(), bullets.size(), bullets.capacity());
+        }
+    }
+
+    std::printf("{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::printf("    {\"name\": \"%s\", \"ops\": %d, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, "
+            "\"p50_ns\": %llu, \"p95_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}%s\n",
+            r.name.c_str(), r.ops, r.nsPerOp, r.allocsPerOp,
+            static_cast<unsigned long long>(r.p50), static_cast<unsigned long long>(r.p95),
+            static_cast<unsigned long long>(r.p99), static_cast<unsigned long long>(r.max),
+            i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+    return 0;
+}
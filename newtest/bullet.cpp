@@ -1,24 +1,161 @@
 #include "bullet.h"
+#include <algorithm>
+#include <cmath>
 
-Bullet::Bullet(const sf::Vector2f& position, const sf::Vector2f& direction, float speed, float damage, const sf::Color& color, bool isEnemyBullet, int splitCount)
-    : damage(damage), isEnemyBullet(isEnemyBullet), splitCount(splitCount) {
-    shape.setRadius(5);               // ӵİ뾶
-    shape.setOrigin(5, 5);            // ԭΪӵ
-    shape.setPosition(position);      // óʼλ
-    shape.setFillColor(color);        // ɫ
-    velocity = direction * speed;     // ٶ
+// 子弹画成正十二边形 (拆成10个三角形)，半径5像素时看起来和原来的圆形一样；顶点相对中心的偏移只计算一次
+static const int BULLET_POINTS = 12;
+static const int VERTICES_PER_BULLET = (BULLET_POINTS - 2) * 3;
+
+struct BulletOutline {
+    sf::Vector2f points[BULLET_POINTS];
+
+    BulletOutline() {
+        for (int i = 0; i < BULLET_POINTS; ++i) {
+            float a = i * 2.f * 3.14159265f / BULLET_POINTS;
+            points[i] = sf::Vector2f(std::cos(a) * BulletPool::RADIUS, std::sin(a) * BulletPool::RADIUS);
+        }
+    }
+};
+
+static const sf::Vector2f* bulletOutline() {
+    static const BulletOutline outline;
+    return outline.points;
+}
+
+BulletPool::BulletPool(size_t capacity)
+    : count(0), patternBullets(0), posX(capacity), posY(capacity), velX(capacity), velY(capacity), damage(capacity),
+      color(capacity), flags(capacity), splitCount(capacity), life(capacity), pattern(capacity), slotOf(capacity),
+      indexOf(capacity), generation(capacity, 0), freeSlots(capacity) {
+    // 栈顶是槽位0
+    for (size_t i = 0; i < capacity; ++i) {
+        freeSlots[i] = static_cast<uint32_t>(capacity - 1 - i);
+    }
+}
+
+BulletHandle BulletPool::spawn(const sf::Vector2f& position, const sf::Vector2f& direction, float speed, float damage, const sf::Color& color, bool isEnemyBullet, int splitCount) {
+    BulletSpawn bullet;
+    bullet.position = position;
+    bullet.velocity = direction * speed;   // 计算速度
+    bullet.damage = damage;
+    bullet.color = color;
+    bullet.flags = isEnemyBullet ? ENEMY_BULLET : 0;
+    bullet.splitCount = static_cast<uint8_t>(std::max(0, std::min(splitCount, 255)));
+    return spawn(bullet);
+}
+
+BulletHandle BulletPool::spawn(const BulletSpawn& bullet) {
+    BulletHandle handle;
+    if (freeSlots.empty()) {
+        return handle;
+    }
+    const uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    const size_t i = count++;
+    posX[i] = bullet.position.x;
+    posY[i] = bullet.position.y;
+    velX[i] = bullet.velocity.x;
+    velY[i] = bullet.velocity.y;
+    damage[i] = bullet.damage;
+    color[i] = bullet.color;
+    flags[i] = bullet.flags;
+    if (bullet.flags & PATTERN_FLAGS) {
+        patternBullets++;
+    }
+    splitCount[i] = bullet.splitCount;
+    life[i] = bullet.life;
+    pattern[i] = bullet.pattern;
+    slotOf[i] = slot;
+    indexOf[slot] = static_cast<uint32_t>(i);
+
+    handle.slot = slot;
+    handle.generation = generation[slot];
+    return handle;
+}
+
+bool BulletPool::isAlive(BulletHandle handle) const {
+    return handle.slot < generation.size() && generation[handle.slot] == handle.generation &&
+        indexOf[handle.slot] < count && slotOf[indexOf[handle.slot]] == handle.slot;
+}
+
+void BulletPool::despawn(BulletHandle handle) {
+    if (isAlive(handle)) {
+        despawnAt(indexOf[handle.slot]);
+    }
+}
+
+void BulletPool::despawnAt(size_t i) {
+    const uint32_t slot = slotOf[i];
+    generation[slot]++;            // 旧句柄失效
+    if (flags[i] & PATTERN_FLAGS) {
+        patternBullets--;
+    }
+    freeSlots.push_back(slot);     // 容量在构造时已经预留，不会分配
+
+    // 最后一颗子弹移到空位
+    const size_t last = --count;
+    if (i != last) {
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        damage[i] = damage[last];
+        color[i] = color[last];
+        flags[i] = flags[last];
+        splitCount[i] = splitCount[last];
+        life[i] = life[last];
+        pattern[i] = pattern[last];
+        slotOf[i] = slotOf[last];
+        indexOf[slotOf[i]] = static_cast<uint32_t>(i);
+    }
+}
+
+void BulletPool::clear() {
+    while (count > 0) {
+        despawnAt(count - 1);
+    }
+}
+
+BulletHandle BulletPool::getHandle(size_t i) const {
+    BulletHandle handle;
+    handle.slot = slotOf[i];
+    handle.generation = generation[handle.slot];
+    return handle;
 }
 
-void Bullet::update() {
-    shape.move(velocity);  // ٶȸӵλ
+void BulletPool::update() {
+    // 根据速度更新子弹的位置
+    for (size_t i = 0; i < count; ++i) {
+        posX[i] += velX[i];
+        posY[i] += velY[i];
+    }
+    // 从后往前回收出界的子弹，换到当前位置的子弹已经检查过
+    for (size_t i = count; i-- > 0;) {
+        if (isOutOfBounds(i)) {
+            despawnAt(i);
+        }
+    }
 }
 
-void Bullet::draw(sf::RenderWindow& window) const {
-    window.draw(shape);  // ڴϻӵ
+void BulletPool::draw(sf::RenderWindow& window) const {
+    if (count == 0) {
+        return;
+    }
+    const sf::Vector2f* outline = bulletOutline();
+    vertices.resize(count * VERTICES_PER_BULLET);
+    sf::Vertex* v = vertices.data();
+    for (size_t i = 0; i < count; ++i) {
+        sf::Vector2f center(posX[i], posY[i]);
+        for (int k = 1; k + 1 < BULLET_POINTS; ++k) {
+            *v++ = sf::Vertex(center + outline[0], color[i]);
+            *v++ = sf::Vertex(center + outline[k], color[i]);
+            *v++ = sf::Vertex(center + outline[k + 1], color[i]);
+        }
+    }
+    window.draw(vertices.data(), vertices.size(), sf::Triangles);
 }
 
-bool Bullet::isOutOfBounds() const {
-    sf::Vector2f pos = shape.getPosition();
-    return pos.x < -10 || pos.x > SCREEN_WIDTH + 10 ||
-        pos.y < -10 || pos.y > SCREEN_HEIGHT + 10;  // ӵǷ񳬳Ļ߽
+bool BulletPool::isOutOfBounds(size_t i) const {
+    return posX[i] < -10 || posX[i] > SCREEN_WIDTH + 10 ||
+        posY[i] < -10 || posY[i] > SCREEN_HEIGHT + 10;  // 检测子弹是否超出屏幕边界
 }
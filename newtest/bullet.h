@@ -2,28 +2,114 @@
 #define BULLET_H
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
 
-const int SCREEN_WIDTH = 800; // Ļ
-const int SCREEN_HEIGHT = 600; // Ļ߶
+const int SCREEN_WIDTH = 800; // 屏幕宽度
+const int SCREEN_HEIGHT = 600; // 屏幕高度
 
-class Bullet {
+// 子弹句柄：槽位编号加代数。子弹被回收后槽位的代数加一，旧句柄自动失效
+struct BulletHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return slot != UINT32_MAX; }
+};
+
+// 一颗子弹的全部初始状态 (弹幕引擎批量发射时直接填写)
+struct BulletSpawn {
+    sf::Vector2f position;
+    sf::Vector2f velocity;      // 每帧的位移
+    float damage = 0.f;
+    sf::Color color;
+    uint8_t flags = 0;          // BulletPool::Flags
+    uint8_t splitCount = 0;     // 子弹的分裂次数
+    uint16_t life = 0;          // 剩余帧数 (带 EXPIRES 标记时有效)
+    uint8_t pattern = 0;        // 所属弹幕图案 (追踪和分裂时查参数)
+};
+
+// 子弹池：容量固定，所有数组在构造时一次分配好，发射和回收子弹都不分配内存。
+// 活动的子弹按结构数组紧密存放在前 size() 个位置 (移动、出界检测和绘制都是线性遍历)，
+// 回收时用最后一颗子弹填补空位；句柄通过槽位表找到子弹当前的位置
+class BulletPool {
 public:
-    Bullet(const sf::Vector2f& position, const sf::Vector2f& direction, float speed, float damage, const sf::Color& color, bool isEnemyBullet, int splitCount = 0);
+    static const size_t DEFAULT_CAPACITY = 65536;
+    static constexpr float RADIUS = 5.f;   // 子弹的半径
+
+    // 子弹的标记位
+    enum Flags : uint8_t {
+        ENEMY_BULLET = 1,   // 敌方子弹
+        HOMING = 2,         // 每帧转向目标 (由弹幕引擎更新)
+        EXPIRES = 4,        // 寿命到了回收，有分裂次数时先分裂 (由弹幕引擎更新)
+        PATTERN_FLAGS = HOMING | EXPIRES
+    };
+
+    explicit BulletPool(size_t capacity = DEFAULT_CAPACITY);
 
+    // 发射一颗子弹，池满时返回无效句柄 (子弹直接丢弃)
+    BulletHandle spawn(const sf::Vector2f& position, const sf::Vector2f& direction, float speed, float damage, const sf::Color& color, bool isEnemyBullet, int splitCount = 0);
+    BulletHandle spawn(const BulletSpawn& bullet);
+    // 回收句柄对应的子弹，句柄已失效时什么也不做
+    void despawn(BulletHandle handle);
+    // 回收第 i 颗活动子弹 (遍历时从后往前删除，前面的下标不受影响)
+    void despawnAt(size_t i);
+    bool isAlive(BulletHandle handle) const;
+    void clear();
+
+    // 所有子弹移动一帧，出界的子弹被回收
     void update();
+    // 所有子弹合成一个顶点数组，一次绘制
     void draw(sf::RenderWindow& window) const;
-    bool isOutOfBounds() const;
 
-    // ȡӵ״ڻƵȣ
-    sf::CircleShape getShape() const { return shape; }
+    size_t size() const { return count; }
+    // 带 PATTERN_FLAGS 的子弹数 (为0时弹幕引擎不用遍历子弹池)
+    size_t getPatternBulletCount() const { return patternBullets; }
+    size_t capacity() const { return posX.size(); }
+
+    // 按下标访问活动子弹 (下标在回收子弹后会变，需要长期引用时用句柄)
+    BulletHandle getHandle(size_t i) const;
+    sf::Vector2f getPosition(size_t i) const { return sf::Vector2f(posX[i], posY[i]); }
+    sf::FloatRect getBounds(size_t i) const { return sf::FloatRect(posX[i] - RADIUS, posY[i] - RADIUS, 2 * RADIUS, 2 * RADIUS); }
+    float getDamage(size_t i) const { return damage[i]; }
+    sf::Vector2f getVelocity(size_t i) const { return sf::Vector2f(velX[i], velY[i]); }
+    const sf::Color& getColor(size_t i) const { return color[i]; }
+    bool isEnemyBullet(size_t i) const { return (flags[i] & ENEMY_BULLET) != 0; }
+    int getSplitCount(size_t i) const { return splitCount[i]; }
+
+    // 弹幕引擎直接读写的列
+    const uint8_t* flagData() const { return flags.data(); }
+    uint16_t* lifeData() { return life.data(); }
+    const uint8_t* patternData() const { return pattern.data(); }
+    float* velocityXData() { return velX.data(); }
+    float* velocityYData() { return velY.data(); }
+    const float* positionXData() const { return posX.data(); }
+    const float* positionYData() const { return posY.data(); }
 
 private:
-    sf::CircleShape shape;      // ӵ״
-    sf::Vector2f velocity;      // ӵٶ
-    float damage;               // ӵ˺
-    bool isEnemyBullet;         // Ƿǵзӵ
-    int splitCount;             // ӵķѴ
+    size_t count;                      // 活动子弹数
+    size_t patternBullets;             // 其中带 PATTERN_FLAGS 的数量
+
+    // 活动子弹 (结构数组)，下标 [0, count)
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> damage;
+    std::vector<sf::Color> color;
+    std::vector<uint8_t> flags;
+    std::vector<uint8_t> splitCount;   // 子弹的分裂次数
+    std::vector<uint16_t> life;        // 剩余帧数 (EXPIRES)
+    std::vector<uint8_t> pattern;      // 所属弹幕图案
+    std::vector<uint32_t> slotOf;      // 活动子弹所在的槽位
+
+    // 槽位表，下标就是句柄里的槽位编号
+    std::vector<uint32_t> indexOf;     // 槽位对应的活动子弹下标
+    std::vector<uint32_t> generation;
+    std::vector<uint32_t> freeSlots;   // 空闲槽位的栈
+
+    mutable std::vector<sf::Vertex> vertices;   // 绘制用，大小跟着最多的子弹数增长
 
+    bool isOutOfBounds(size_t i) const;
 };
 
 #endif // BULLET_H
@@ -1,21 +1,61 @@
 #include "enemy.h"
 #include "bullet.h"
+#include "pattern.h"
 #include <cmath>
 #include <memory>
 
 const float PI = 3.14159265359f;
 
-// Enemyʵ
+// 各种敌人的弹幕图案编号
+struct EnemyPatterns {
+    PatternEngine engine;
+    uint8_t hexagonAimed;     // 六边形：朝玩家的主弹幕
+    uint8_t hexagonSides;     // 六边形：其余五条边
+    uint8_t pentagonFan;      // 五边形：扇形弹幕
+
+    EnemyPatterns() {
+        PatternDesc desc;
+        desc.shape = PatternShape::FAN;
+        desc.count = 1;
+        desc.speed = 4.5f;
+        hexagonAimed = engine.add(desc);
+
+        // 相对玩家方向 60°、120° ... 300°
+        desc.count = 5;
+        desc.spread = 4 * PI / 3;
+        desc.angleOffset = PI;
+        desc.speed = 4.0f;
+        hexagonSides = engine.add(desc);
+
+        // 以玩家方向为中心，每隔 15° 一发
+        desc.count = 5;
+        desc.spread = 4 * PI / 12;
+        desc.angleOffset = 0;
+        desc.speed = 4.2f;
+        pentagonFan = engine.add(desc);
+    }
+};
+
+static const EnemyPatterns& patternTable() {
+    static const EnemyPatterns table;
+    return table;
+}
+
+const PatternEngine& enemyPatterns() {
+    return patternTable().engine;
+}
+
+// 基类Enemy实现
 Enemy::Enemy(EnemyType type, int level)
-    : enemyType(type), health(1), speed(2.0f), attackCooldown(60), lastAttackTime(0), points(10), level(level) {
-    // ݹؿ
+    : enemyType(type), health(1), speed(2.0f), attackCooldown(60), lastAttackTime(0), points(10), level(level), volleyCount(0) {
+    // 根据关卡调整属性
     health += level;
     speed += level * 0.2f;
     points += level * 5;
 }
 
-void Enemy::update(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) {
-    // ᱻ
+void Enemy::update(const sf::Vector2f& playerPos, BulletPool& bullets) {
+    // 这个方法会被各个敌人类型重载
 }
 
 void Enemy::draw(sf::RenderWindow& window) const {
@@ -27,29 +67,33 @@ void Enemy::takeDamage(int damage) {
 }
 
 void Enemy::setShapeColor(int level) {
-    // ݹؿɫ
+    // 根据关卡设置颜色
     if (level <= 5) shape->setFillColor(sf::Color::Red);
     else if (level <= 10) shape->setFillColor(sf::Color::Magenta);
     else shape->setFillColor(sf::Color::White);
 }
 
-std::unique_ptr<Bullet> Enemy::createBullet(const sf::Vector2f& position, const sf::Vector2f& direction, float speed, float damage, const sf::Color& color) {
-    return std::make_unique<Bullet>(position, direction, speed, damage, color, true);
+void Enemy::firePattern(uint8_t pattern, BulletPool& bullets, const sf::Vector2f& playerPos, float damage) {
+    sf::Vector2f aim = normalize(playerPos - shape->getPosition());
+    if (aim.x == 0 && aim.y == 0) {
+        aim = sf::Vector2f(1, 0);
+    }
+    enemyPatterns().fire(pattern, bullets, shape->getPosition(), aim, volleyCount++, damage, shape->getFillColor());
 }
 
-// TriangleEnemyʵ
+// TriangleEnemy实现
 TriangleEnemy::TriangleEnemy(int level) : Enemy(EnemyType::TRIANGLE, level), state(State::IDLE), chargeTime(0), dashSpeed(8.0f), dashDuration(0) {
-    shape = std::make_unique<sf::CircleShape>(15, 3); // 
+    shape = std::make_unique<sf::CircleShape>(15, 3); // 三角形
     health = 3 + level * 2;
     speed = 1.5f + level * 0.1f;
-    attackCooldown = 120 - level * 5; // 
+    attackCooldown = 120 - level * 5; // 攻击间隔
     points = 15 + level * 5;
 
-    setShapeColor(level);  // ɫ
+    setShapeColor(level);  // 设置颜色
     shape->setOrigin(15, 15);
 }
 
-void TriangleEnemy::update(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) {
+void TriangleEnemy::update(const sf::Vector2f& playerPos, BulletPool& bullets) {
     switch (state) {
     case State::IDLE:
         idleState(playerPos, bullets);
@@ -63,11 +107,11 @@ void TriangleEnemy::update(const sf::Vector2f& playerPos, std::vector<std::uniqu
     }
 }
 
-void TriangleEnemy::idleState(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) {
-    // ƶ
+void TriangleEnemy::idleState(const sf::Vector2f& playerPos, BulletPool& bullets) {
+    // 正常移动
     Enemy::update(playerPos, bullets);
 
-    // ״̬
+    // 随机进入冲锋状态
     if (rand() % 200 == 0) {
         state = State::CHARGING;
         chargeTime = 0;
@@ -75,19 +119,19 @@ void TriangleEnemy::idleState(const sf::Vector2f& playerPos, std::vector<std::un
 }
 
 void TriangleEnemy::chargingState() {
-    // ׶
+    // 蓄力阶段
     chargeTime++;
     shape->setScale(1.0f + chargeTime * 0.01f, 1.0f + chargeTime * 0.01f);
 
     if (chargeTime >= 30) {
         state = State::DASHING;
-        dashDirection = normalize(shape->getPosition() - shape->getPosition()); // ٶǳҷ
+        dashDirection = normalize(shape->getPosition() - shape->getPosition()); // 假定是朝玩家方向冲刺
         dashDuration = 40;
     }
 }
 
 void TriangleEnemy::dashingState() {
-    // ̽׶
+    // 冲刺阶段
     shape->move(dashDirection * dashSpeed);
     dashDuration--;
 
@@ -97,57 +141,41 @@ void TriangleEnemy::dashingState() {
     }
 }
 
-void TriangleEnemy::attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) {
-    // ̹ӵֱײ˺
+void TriangleEnemy::attack(const sf::Vector2f& playerPos, BulletPool& bullets) {
+    // 冲刺攻击不发射子弹，直接碰撞伤害
 }
 
-// HexagonEnemyʵ
+// HexagonEnemy实现
 HexagonEnemy::HexagonEnemy(int level) : Enemy(EnemyType::HEXAGON, level), rotationSpeed(1.0f) {
-    shape = std::make_unique<sf::CircleShape>(18, 6); // 
+    shape = std::make_unique<sf::CircleShape>(18, 6); // 六边形
     health = 5 + level * 2;
     speed = 1.2f + level * 0.1f;
     attackCooldown = 100 - level * 5;
     points = 20 + level * 5;
 
-    setShapeColor(level);  // ɫ
+    setShapeColor(level);  // 设置颜色
     shape->setOrigin(18, 18);
 }
 
-void HexagonEnemy::attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) {
-    // ҵı߷һĻ
-    sf::Vector2f direction = normalize(playerPos - shape->getPosition());
-    float angleToPlayer = std::atan2(direction.y, direction.x);
-
-    // Ļ
-    bullets.emplace_back(createBullet(shape->getPosition(), direction, 4.5f, 1.0f + level * 0.2f, shape->getFillColor()));
-
-    // Χ߸һĻ
-    for (int i = 0; i < 5; i++) {
-        float angle = angleToPlayer + (i + 1) * PI / 3;
-        sf::Vector2f dir(std::cos(angle), std::sin(angle));
-        bullets.emplace_back(createBullet(shape->getPosition(), dir, 4.0f, 0.8f + level * 0.1f, shape->getFillColor()));
-    }
+void HexagonEnemy::attack(const sf::Vector2f& playerPos, BulletPool& bullets) {
+    // 朝玩家的边发射主弹幕，周围五条边各发射一发弹幕
+    firePattern(patternTable().hexagonAimed, bullets, playerPos, 1.0f + level * 0.2f);
+    firePattern(patternTable().hexagonSides, bullets, playerPos, 0.8f + level * 0.1f);
 }
 
-// PentagonEnemyʵ
+// PentagonEnemy实现
 PentagonEnemy::PentagonEnemy(int level) : Enemy(EnemyType::PENTAGON, level), rotationSpeed(2.0f) {
-    shape = std::make_unique<sf::CircleShape>(20, 5); // 
+    shape = std::make_unique<sf::CircleShape>(20, 5); // 五边形
     health = 4 + level * 2;
     speed = 1.3f + level * 0.1f;
     attackCooldown = 80 - level * 4;
     points = 18 + level * 5;
 
-    setShapeColor(level);  // ɫ
+    setShapeColor(level);  // 设置颜色
     shape->setOrigin(20, 20);
 }
 
-void PentagonEnemy::attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) {
-    // תεĻ
-    float baseAngle = std::atan2(playerPos.y - shape->getPosition().y, playerPos.x - shape->getPosition().x);
-
-    for (int i = -2; i <= 2; i++) {
-        float angle = baseAngle + i * PI / 12;
-        sf::Vector2f dir(std::cos(angle), std::sin(angle));
-        bullets.emplace_back(createBullet(shape->getPosition(), dir, 4.2f, 0.9f + level * 0.15f, shape->getFillColor()));
-    }
+void PentagonEnemy::attack(const sf::Vector2f& playerPos, BulletPool& bullets) {
+    // 旋转并发射扇形弹幕
+    firePattern(patternTable().pentagonFan, bullets, playerPos, 0.9f + level * 0.15f);
 }
@@ -5,16 +5,20 @@
 #include <vector>
 #include <memory>
 
-class Bullet;
+class BulletPool;
+class PatternEngine;
+
+// 敌人使用的弹幕图案 (第一次使用时编译)，子弹池里的追踪和分裂子弹也由它每帧更新
+const PatternEngine& enemyPatterns();
 
 class Enemy {
 public:
     Enemy(EnemyType type, int level);
     virtual ~Enemy() = default;
 
-    virtual void update(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets);
+    virtual void update(const sf::Vector2f& playerPos, BulletPool& bullets);
     virtual void draw(sf::RenderWindow& window) const;
-    virtual void attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) = 0;
+    virtual void attack(const sf::Vector2f& playerPos, BulletPool& bullets) = 0;
 
     void takeDamage(int damage);
     bool isAlive() const { return health > 0; }
@@ -23,7 +27,7 @@ public:
     int getLevel() const { return level; }
 
 protected:
-    // ״Լ
+    // 形状对象以及敌人类型
     std::unique_ptr<sf::Shape> shape;
     EnemyType enemyType;
     int health;
@@ -33,16 +37,18 @@ protected:
     int points;
     int level;
 
-    // ͨ÷ɫ
+    // 通用方法：设置颜色
     void setShapeColor(int level);
-    std::unique_ptr<Bullet> createBullet(const sf::Vector2f& position, const sf::Vector2f& direction, float speed, float damage, const sf::Color& color);
+    // 以朝向玩家的方向发射一轮弹幕图案
+    void firePattern(uint8_t pattern, BulletPool& bullets, const sf::Vector2f& playerPos, float damage);
+    unsigned volleyCount;   // 已经发射的轮数 (螺旋图案的相位)
 };
 
 class TriangleEnemy : public Enemy {
 public:
     TriangleEnemy(int level);
-    void attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) override;
-    void update(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) override;
+    void attack(const sf::Vector2f& playerPos, BulletPool& bullets) override;
+    void update(const sf::Vector2f& playerPos, BulletPool& bullets) override;
 
 private:
     enum class State { IDLE, CHARGING, DASHING };
@@ -52,8 +58,8 @@ private:
     float dashDuration;
     sf::Vector2f dashDirection;
 
-    // ״̬߼
-    void idleState(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets);
+    // 分离状态机的逻辑
+    void idleState(const sf::Vector2f& playerPos, BulletPool& bullets);
     void chargingState();
     void dashingState();
 };
@@ -61,7 +67,7 @@ private:
 class HexagonEnemy : public Enemy {
 public:
     HexagonEnemy(int level);
-    void attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) override;
+    void attack(const sf::Vector2f& playerPos, BulletPool& bullets) override;
 
 private:
     float rotationSpeed;
@@ -70,7 +76,7 @@ private:
 class PentagonEnemy : public Enemy {
 public:
     PentagonEnemy(int level);
-    void attack(const sf::Vector2f& playerPos, std::vector<std::unique_ptr<Bullet>>& bullets) override;
+    void attack(const sf::Vector2f& playerPos, BulletPool& bullets) override;
 
 private:
     float rotationSpeed;
@@ -1,4 +1,6 @@
 #include "gamestate.h"
+#include "enemy.h"
+#include "pattern.h"
 
 GameState::GameState() : window(sf::VideoMode(800, 600), "Robot Battle"), player(RobotType::TYPE1) {
     window.setFramerateLimit(60);
@@ -24,12 +26,9 @@ void GameState::handleInput() {
 void GameState::update() {
     player.update(window.mapPixelToCoords(sf::Mouse::getPosition(window)), bullets);
 
-    for (auto& bullet : bullets)
-        bullet->update();
-
-    // Ƴӵ
-    bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-        [](const std::unique_ptr<Bullet>& b) { return b->isOffScreen(); }), bullets.end());
+    // 追踪和分裂的敌方子弹，然后移动子弹并回收出界子弹
+    enemyPatterns().update(bullets, player.getShape().getPosition());
+    bullets.update();
 }
 
 void GameState::render() {
@@ -37,8 +36,7 @@ void GameState::render() {
 
     player.draw(window);
 
-    for (const auto& bullet : bullets)
-        bullet->draw(window);
+    bullets.draw(window);
 
     window.display();
 }
@@ -21,7 +21,7 @@ public:
 private:
     sf::RenderWindow window;
     Player player; // ✅ 使用 Player 类没问题了
-    std::vector<std::unique_ptr<Bullet>> bullets;
+    BulletPool bullets;   // 固定容量的子弹池，发射子弹不分配内存
 
     sf::Clock clock;
 
@@ -0,0 +1,155 @@
+#include "pattern.h"
+#include <cmath>
+
+static const float TWO_PI = 6.28318530718f;
+
+// 把 v 旋转到以 rotation (cos, sin) 表示的方向
+static sf::Vector2f rotate(const sf::Vector2f& v, const sf::Vector2f& rotation) {
+    return sf::Vector2f(v.x * rotation.x - v.y * rotation.y, v.x * rotation.y + v.y * rotation.x);
+}
+
+static sf::Vector2f unitVector(float angle) {
+    return sf::Vector2f(std::cos(angle), std::sin(angle));
+}
+
+uint8_t PatternEngine::add(const PatternDesc& desc) {
+    if (patterns.size() >= MAX_PATTERNS) {
+        return INVALID_PATTERN;
+    }
+    Compiled pattern;
+    pattern.desc = desc;
+    pattern.firstDirection = static_cast<uint32_t>(directions.size());
+    pattern.firstPhase = static_cast<uint32_t>(phases.size());
+    pattern.phaseCount = 0;
+
+    // 每颗子弹相对瞄准方向的角度
+    const int count = desc.count;
+    for (int k = 0; k < count; ++k) {
+        float angle = desc.angleOffset;
+        if (desc.shape == PatternShape::RING) {
+            angle += k * TWO_PI / count;
+        }
+        else if (count > 1) {
+            angle += -desc.spread / 2 + k * desc.spread / (count - 1);
+        }
+        directions.push_back(unitVector(angle));
+    }
+
+    // 螺旋：第 k 轮整体多转 k * 2π/spinSteps
+    if (desc.spinSteps != 0) {
+        const int steps = std::abs(static_cast<int>(desc.spinSteps));
+        const float step = TWO_PI / desc.spinSteps;
+        for (int k = 0; k < steps; ++k) {
+            phases.push_back(unitVector(k * step));
+        }
+        pattern.phaseCount = static_cast<uint16_t>(steps);
+    }
+
+    pattern.flags = 0;
+    if (desc.homingTurn > 0.f) {
+        pattern.flags |= BulletPool::HOMING;
+    }
+    if (desc.lifetime > 0) {
+        pattern.flags |= BulletPool::EXPIRES;
+    }
+    pattern.turnCos = std::cos(desc.homingTurn);
+    pattern.turnSin = std::sin(desc.homingTurn);
+
+    patterns.push_back(pattern);
+    return static_cast<uint8_t>(patterns.size() - 1);
+}
+
+size_t PatternEngine::fire(uint8_t id, BulletPool& bullets, const sf::Vector2f& origin, const sf::Vector2f& aim, unsigned volley,
+    float damage, const sf::Color& color, bool isEnemyBullet) const {
+    if (id >= patterns.size()) {
+        return 0;
+    }
+    const Compiled& pattern = patterns[id];
+    sf::Vector2f rotation = aim;
+    if (pattern.phaseCount > 0) {
+        rotation = rotate(phases[pattern.firstPhase + volley % pattern.phaseCount], aim);
+    }
+    return emit(pattern, bullets, origin, rotation, damage, color,
+        isEnemyBullet ? BulletPool::ENEMY_BULLET : 0, pattern.desc.splitCount);
+}
+
+size_t PatternEngine::emit(const Compiled& pattern, BulletPool& bullets, const sf::Vector2f& origin, const sf::Vector2f& rotation,
+    float damage, const sf::Color& color, uint8_t sideFlags, uint8_t splitCount) const {
+    BulletSpawn bullet;
+    bullet.position = origin;
+    bullet.damage = damage;
+    bullet.color = color;
+    bullet.flags = static_cast<uint8_t>(pattern.flags | sideFlags);
+    bullet.splitCount = splitCount;
+    bullet.life = pattern.desc.lifetime;
+    bullet.pattern = static_cast<uint8_t>(&pattern - patterns.data());
+
+    const sf::Vector2f* table = directions.data() + pattern.firstDirection;
+    const size_t count = pattern.desc.count;
+    const float speed = pattern.desc.speed;
+    for (size_t k = 0; k < count; ++k) {
+        bullet.velocity = rotate(table[k], rotation) * speed;
+        if (!bullets.spawn(bullet).isValid()) {
+            return k;
+        }
+    }
+    return count;
+}
+
+void PatternEngine::update(BulletPool& bullets, const sf::Vector2f& target) const {
+    if (bullets.getPatternBulletCount() == 0) {
+        return;
+    }
+    // 子弹池的数组在构造时分配好，分裂时追加子弹不会让这些指针失效
+    const uint8_t* flags = bullets.flagData();
+    uint16_t* life = bullets.lifeData();
+    const uint8_t* pattern = bullets.patternData();
+    float* velX = bullets.velocityXData();
+    float* velY = bullets.velocityYData();
+    const float* posX = bullets.positionXData();
+    const float* posY = bullets.positionYData();
+    // 从后往前处理：回收时换过来的是已经处理过的子弹或本帧刚分裂出的子弹
+    for (size_t i = bullets.size(); i-- > 0;) {
+        const uint8_t f = flags[i];
+        if ((f & BulletPool::PATTERN_FLAGS) == 0 || pattern[i] >= patterns.size()) {
+            continue;
+        }
+        const Compiled& compiled = patterns[pattern[i]];
+
+        if (f & BulletPool::HOMING) {
+            const float tx = target.x - posX[i];
+            const float ty = target.y - posY[i];
+            const float vx = velX[i];
+            const float vy = velY[i];
+            const float speed2 = vx * vx + vy * vy;
+            const float lengths = std::sqrt(speed2 * (tx * tx + ty * ty));   // |v| * |t|
+            if (lengths > 0.f) {
+                if (vx * tx + vy * ty >= compiled.turnCos * lengths) {
+                    // 目标在一帧的转角以内，直接对准 (速度大小不变)
+                    const float scale = speed2 / lengths;
+                    velX[i] = tx * scale;
+                    velY[i] = ty * scale;
+                }
+                else {
+                    // 朝目标所在的一侧转最大角度
+                    const float s = vx * ty - vy * tx >= 0.f ? compiled.turnSin : -compiled.turnSin;
+                    velX[i] = vx * compiled.turnCos - vy * s;
+                    velY[i] = vx * s + vy * compiled.turnCos;
+                }
+            }
+        }
+
+        if ((f & BulletPool::EXPIRES) && --life[i] == 0) {
+            const uint8_t split = static_cast<uint8_t>(bullets.getSplitCount(i));
+            if (split > 0 && compiled.desc.child < patterns.size()) {
+                // 以飞行方向为瞄准方向发射子图案
+                sf::Vector2f velocity(velX[i], velY[i]);
+                float length = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+                sf::Vector2f aim = length > 0.f ? velocity / length : sf::Vector2f(1.f, 0.f);
+                emit(patterns[compiled.desc.child], bullets, bullets.getPosition(i), aim, bullets.getDamage(i),
+                    bullets.getColor(i), f & BulletPool::ENEMY_BULLET, static_cast<uint8_t>(split - 1));
+            }
+            bullets.despawnAt(i);
+        }
+    }
+}
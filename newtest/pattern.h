@@ -0,0 +1,71 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "bullet.h"
+#include <cstdint>
+#include <vector>
+
+// 一轮弹幕的形状
+enum class PatternShape : uint8_t {
+    RING,   // 整圈均匀分布
+    FAN     // 以瞄准方向为中心的扇形
+};
+
+// 弹幕图案的参数记录。螺旋、到期分裂和追踪是叠加在环形/扇形上的修饰，可以组合使用
+struct PatternDesc {
+    PatternShape shape = PatternShape::FAN;
+    uint16_t count = 1;          // 每轮子弹数
+    float spread = 0.f;          // 扇形两端子弹之间的角度 (弧度)
+    float angleOffset = 0.f;     // 整轮相对瞄准方向的偏移 (弧度)
+    float speed = 4.f;           // 每帧的位移
+    int16_t spinSteps = 0;       // 螺旋：每轮多转 2π/spinSteps (负数为逆时针)，0 表示不旋转
+    uint16_t lifetime = 0;       // 子弹的寿命 (帧)，0 表示不会到期
+    uint8_t splitCount = 0;      // 到期时还能分裂几代
+    uint8_t child = 0;           // 分裂出的子弹使用的图案 (以到期子弹的飞行方向为瞄准方向)
+    float homingTurn = 0.f;      // 追踪：每帧最多转过的角度 (弧度)，0 表示不追踪
+};
+
+// 弹幕引擎：图案在 add 时编译成单位方向表 (螺旋另有每轮的旋转表)，
+// 发射时只需把表里的方向旋转到瞄准方向 (复数乘法)，整轮直接写进子弹池，不调用三角函数。
+// 追踪和到期分裂的子弹由 update 每帧在子弹池上批量处理
+class PatternEngine {
+public:
+    static const uint8_t INVALID_PATTERN = 255;  // 无效的图案编号
+    static const size_t MAX_PATTERNS = 255;      // 图案编号存成一个字节，255 留给 INVALID_PATTERN
+
+    // 编译一个图案，返回图案编号；已经有 MAX_PATTERNS 个图案时返回 INVALID_PATTERN
+    // (用 isValid 检查，无效的编号发射时什么也不做)
+    uint8_t add(const PatternDesc& desc);
+    bool isValid(uint8_t id) const { return id < patterns.size(); }
+    const PatternDesc& get(uint8_t id) const { return patterns[id].desc; }
+    size_t size() const { return patterns.size(); }
+
+    // 从 origin 发射一轮。aim 为单位向量 (通常指向玩家)，volley 为第几轮 (螺旋用)；
+    // 子弹池满时剩下的子弹直接丢弃，返回实际发射的数量
+    size_t fire(uint8_t id, BulletPool& bullets, const sf::Vector2f& origin, const sf::Vector2f& aim, unsigned volley,
+        float damage, const sf::Color& color, bool isEnemyBullet = true) const;
+
+    // 每帧在子弹池移动子弹前调用：追踪子弹转向 target，到期的子弹分裂并回收
+    void update(BulletPool& bullets, const sf::Vector2f& target) const;
+
+private:
+    // 编译后的图案：方向和旋转都放在共用的表里
+    struct Compiled {
+        PatternDesc desc;
+        uint32_t firstDirection;
+        uint32_t firstPhase;
+        uint16_t phaseCount;
+        uint8_t flags;            // 发射出的子弹带的 BulletPool::Flags (不含敌我)
+        float turnCos;            // 追踪的最大转角
+        float turnSin;
+    };
+
+    std::vector<Compiled> patterns;
+    std::vector<sf::Vector2f> directions;   // 相对瞄准方向的单位向量
+    std::vector<sf::Vector2f> phases;       // 螺旋每轮的旋转 (cos, sin)
+
+    size_t emit(const Compiled& pattern, BulletPool& bullets, const sf::Vector2f& origin, const sf::Vector2f& rotation,
+        float damage, const sf::Color& color, uint8_t sideFlags, uint8_t splitCount) const;
+};
+
+#endif // PATTERN_H
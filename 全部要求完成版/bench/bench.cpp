@@ -0,0 +1,325 @@
+// 模拟热点的基准测试 (不打开窗口)。
+// 编译时加入上一级目录中除 main.cpp 以外的所有 .cpp，例如：
+//     g++ -std=c++17 -O2 -I.. bench.cpp ../world.cpp ../obstacle.cpp ... -lsfml-graphics -lsfml-window -lsfml-system -pthread
+// 用法：bench [--filter 名字] [--scale 倍数] [--threads 工作线程数]，结果以 JSON 输出到标准输出
+// 计时和 JSON 格式与 newtest/bench/pattern_bench.cpp 相同 (两个游戏是各自独立的项目，不共用代码)，改动时两边一起改
+#include "../world.h"
+#include "../savefile.h"
+#include "../jobs.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// 统计堆分配次数 (替换全局 operator new)
+static std::atomic<unsigned long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 一个场景：setup 准备数据 (不计时)，op 执行一次被测操作
+struct Scenario {
+    std::string name;
+    int warmup;
+    int iterations;
+    std::function<void()> setup;
+    std::function<void()> op;
+};
+
+struct Result {
+    std::string name;
+    int ops;
+    double nsPerOp;
+    double allocsPerOp;
+    uint64_t p50;
+    uint64_t p95;
+    uint64_t p99;
+    uint64_t max;
+};
+
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static Result runScenario(const Scenario& scenario) {
+    scenario.setup();
+    for (int i = 0; i < scenario.warmup; ++i) {
+        scenario.op();
+    }
+
+    std::vector<uint64_t> samples;
+    samples.reserve(scenario.iterations);
+    unsigned long long allocationsBefore = allocationCount.load();
+    uint64_t total = 0;
+    for (int i = 0; i < scenario.iterations; ++i) {
+        uint64_t start = nowNs();
+        scenario.op();
+        uint64_t elapsed = nowNs() - start;
+        samples.push_back(elapsed);
+        total += elapsed;
+    }
+    // samples 已预留好空间，计时期间不会分配
+    unsigned long long allocations = allocationCount.load() - allocationsBefore;
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = scenario.name;
+    result.ops = scenario.iterations;
+    result.nsPerOp = static_cast<double>(total) / scenario.iterations;
+    result.allocsPerOp = static_cast<double>(allocations) / scenario.iterations;
+    result.p50 = percentile(samples, 0.50);
+    result.p95 = percentile(samples, 0.95);
+    result.p99 = percentile(samples, 0.99);
+    result.max = samples.back();
+    return result;
+}
+
+// 所有场景都在地图中心 (玩家出生点) 附近进行
+static const sf::Vector2f MAP_CENTER(MAP_WIDTH / 2.f, MAP_HEIGHT / 2.f);
+
+// 密集障碍物：按第20关的规则生成地图中心周围的区块
+static void denseObstacles(ObstacleGrid& obstacles, Rng& rng) {
+    obstacles.reset(20, rng.next());
+    obstacles.streamAround(MAP_CENTER);
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    int scale = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--filter") {
+            filter = argv[i + 1];
+        }
+        else if (arg == "--scale") {
+            scale = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (arg == "--threads") {
+            JobSystem::instance().setWorkerCount(static_cast<unsigned>(std::max(0, std::atoi(argv[i + 1]))));
+        }
+    }
+
+    // 所有场景共用的数据，每个场景的 setup 重新生成
+    Rng rng;
+    ObstacleGrid obstacles;
+    FlowField flowField;
+    MonsterStore monsters;
+    std::vector<Bullet> bullets;
+    ParticlePool particles(World::PARTICLE_CAPACITY);
+    ShapeBatch batch;
+    sf::Vector2f target;
+    int frame = 0;
+
+    std::vector<Scenario> scenarios;
+
+    // 流场、出生点和随机目标的范围 (与 World 的 nearArea 相同)
+    sf::FloatRect area;
+
+    // 500只怪物在密集障碍物中追击绕圈移动的目标，一次操作为一个逻辑帧
+    scenarios.push_back(Scenario{ "monster_chase_500", 60, 600 * scale,
+        [&]() {
+            rng.reseed(1);
+            denseObstacles(obstacles, rng);
+            area = obstacles.getChunkArea(World::NEAR_CHUNK_RADIUS);
+            flowField.build(obstacles, area);
+            monsters.clear();
+            monsters.spawnWave(125, obstacles, area, rng);
+            bullets.clear();
+            bullets.reserve(4096);
+            particles.clear();
+            frame = 0;
+        },
+        [&]() {
+            float angle = frame++ * 0.01f;
+            target = MAP_CENTER + sf::Vector2f(300.f * std::cos(angle), 300.f * std::sin(angle));
+            flowField.setTarget(target);
+            monsters.update(target, flowField, particles, bullets, obstacles, area, area, frame, rng.next());
+            particles.update();
+            bullets.clear();
+        } });
+
+    // 10000颗子弹在障碍物之间飞行，撞到障碍物或飞出范围的子弹在中心重新发射
+    scenarios.push_back(Scenario{ "bullets_10k", 30, 600 * scale,
+        [&]() {
+            rng.reseed(2);
+            denseObstacles(obstacles, rng);
+            area = obstacles.getChunkArea(World::NEAR_CHUNK_RADIUS);
+            bullets.clear();
+            bullets.reserve(10000);
+            for (int i = 0; i < 10000; ++i) {
+                sf::Vector2f to(area.left + rng.nextFloat() * area.width, area.top + rng.nextFloat() * area.height);
+                bullets.emplace_back(MAP_CENTER, to, (i & 1) != 0);
+            }
+        },
+        [&]() {
+            for (Bullet& bullet : bullets) {
+                sf::FloatRect bounds = bullet.getBounds();
+                if (!bullet.move(obstacles) || !area.contains(bounds.left, bounds.top)) {
+                    sf::Vector2f to(area.left + rng.nextFloat() * area.width, area.top + rng.nextFloat() * area.height);
+                    bullet = Bullet(MAP_CENTER, to, bullet.isFromPlayer());
+                }
+            }
+        } });
+
+    // 4096条随机视线在密集障碍物中的批量检测 (子弹大小的包围盒在活动区块内任意两点之间平移)，一次操作为一批
+    std::vector<SweepQuery> casts;
+    std::vector<RayHit> hits;
+    scenarios.push_back(Scenario{ "los_batch_4096", 30, 300 * scale,
+        [&]() {
+            rng.reseed(6);
+            denseObstacles(obstacles, rng);
+            area = obstacles.getChunkArea(ObstacleGrid::ACTIVE_RADIUS);
+            casts.clear();
+            for (int i = 0; i < 4096; ++i) {
+                sf::Vector2f from(area.left + rng.nextFloat() * area.width, area.top + rng.nextFloat() * area.height);
+                sf::Vector2f to(area.left + rng.nextFloat() * area.width, area.top + rng.nextFloat() * area.height);
+                casts.push_back(SweepQuery{ sf::FloatRect(from, sf::Vector2f(Bullet::SIZE, Bullet::SIZE)), to - from });
+            }
+            hits.resize(casts.size());
+        },
+        [&]() {
+            obstacles.castBox(casts.data(), casts.size(), hits.data());
+        } });
+
+    // 近战玩家一次完整的横扫 (动画、粒子和范围伤害)，周围有300只怪物
+    MeleePlayer melee;
+    scenarios.push_back(Scenario{ "melee_sweep_crowd_300", 5, 100 * scale,
+        [&]() {
+            rng.reseed(3);
+            obstacles.clear();
+            particles.clear();
+        },
+        [&]() {
+            monsters.clear();
+            for (int i = 0; i < 300; ++i) {
+                float angle = i * 0.37f;
+                float dist = 20.f + (i % 10) * 12.f;
+                monsters.add(static_cast<MonsterKind>(i % MONSTER_KIND_COUNT),
+                    MAP_CENTER + sf::Vector2f(dist * std::cos(angle) - 15.f, dist * std::sin(angle) - 15.f));
+            }
+            melee.startSweep();
+            bool damageApplied = false;
+            while (melee.isSweeping()) {
+                melee.updateSweep(particles, rng);
+                particles.update();
+                // 与 World::updateSweep 相同的范围伤害
+                if (!damageApplied && melee.getSweepAngle() > 180.f) {
+                    sf::Vector2f center = melee.getCenter();
+                    for (size_t i = monsters.size(); i-- > 0;) {
+                        sf::Vector2f mCenter = monsters.getCenter(i);
+                        if (std::hypot(center.x - mCenter.x, center.y - mCenter.y) <= melee.getAttackRange()) {
+                            emitDeathEffect(particles, mCenter, monsterKindColors[monsters.kind[i]], rng);
+                            monsters.removeSwap(i);
+                        }
+                    }
+                    damageApplied = true;
+                }
+            }
+        } });
+
+    // 粒子风暴：每帧发射2000个粒子，更新并生成绘制顶点 (粒子池满后稳定在容量附近)
+    scenarios.push_back(Scenario{ "particle_storm", 120, 600 * scale,
+        [&]() {
+            rng.reseed(4);
+            particles.clear();
+            batch.clear();
+            batch.reserve(World::PARTICLE_CAPACITY * 6);
+        },
+        [&]() {
+            for (int i = 0; i < 2000; ++i) {
+                sf::Vector2f position(static_cast<float>(rng.nextInt(WINDOW_WIDTH)), static_cast<float>(rng.nextInt(WINDOW_HEIGHT)));
+                emitDeathEffect(particles, position, sf::Color::Red, rng);
+            }
+            particles.update();
+            batch.clear();
+            particles.appendTo(batch);
+        } });
+
+    // 关卡生成：依次生成第1到第 LEVELGEN_MAX_LEVEL 关出生点周围的障碍物区块、流场和怪物，一次操作为一关
+    const int LEVELGEN_MAX_LEVEL = 100;
+    int level = 0;
+    scenarios.push_back(Scenario{ "level_generation", LEVELGEN_MAX_LEVEL, LEVELGEN_MAX_LEVEL * 10 * scale,
+        [&]() {
+            rng.reseed(5);
+            level = 0;
+        },
+        [&]() {
+            level = level % LEVELGEN_MAX_LEVEL + 1;
+            obstacles.reset(level, rng.next());
+            obstacles.streamAround(MAP_CENTER);
+            area = obstacles.getChunkArea(World::NEAR_CHUNK_RADIUS);
+            flowField.build(obstacles, area);
+            monsters.clear();
+            monsters.spawnWave(level + 1, obstacles, area, rng);
+        } });
+
+    // 存档读写：生成完整快照、写入文件、读回并恢复世界
+    World world;
+    World restored;
+    const std::string savePath = "bench_save.dat";
+    scenarios.push_back(Scenario{ "save_load_roundtrip", 10, 200 * scale,
+        [&]() {
+            world.start(1, MAX_LEVEL, 0, PLAYER_MAX_HEALTH, 6);
+            InputFrame input;
+            for (int i = 0; i < 120; ++i) {
+                input.right = i % 60 < 30;
+                input.left = !input.right;
+                world.step(input);
+            }
+        },
+        [&]() {
+            WorldSnapshot snapshot;
+            world.writeSnapshot(snapshot);
+            writeSaveFile(savePath, snapshot);
+            SaveSummary summary;
+            readSaveFile(savePath, snapshot, summary);
+            restored.readSnapshot(snapshot);
+        } });
+
+    std::vector<Result> results;
+    for (const Scenario& scenario : scenarios) {
+        if (filter.empty() || scenario.name.find(filter) != std::string::npos) {
+            results.push_back(runScenario(scenario));
+        }
+    }
+    std::remove(savePath.c_str());
+
+    std::printf("{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::printf("    {\"name\": \"%s\", \"ops\": %d, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, "
+            "\"p50_ns\": %llu, \"p95_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}%s\n",
+            r.name.c_str(), r.ops, r.nsPerOp, r.allocsPerOp,
+            static_cast<unsigned long long>(r.p50), static_cast<unsigned long long>(r.p95),
+            static_cast<unsigned long long>(r.p99), static_cast<unsigned long long>(r.max),
+            i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "bullet.h"
+#include "savefile.h"
+#include <cmath>
+
+Bullet::Bullet(const sf::Vector2f& startPos, const sf::Vector2f& target, bool isPlayerBullet, float speed) {
+    shape.setSize(sf::Vector2f(SIZE, SIZE));
+    shape.setFillColor(isPlayerBullet ? sf::Color::Cyan : sf::Color::Yellow);
+    shape.setPosition(startPos);
+
+    sf::Vector2f direction = target - startPos;
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (length > 0) {
+        direction /= length;
+        velocity = direction * speed; // 子弹速度
+    }
+    this->isPlayerBullet = isPlayerBullet;
+}
+
+bool Bullet::move(const ObstacleGrid& obstacles) {
+    RayHit contact;
+    if (obstacles.sweep(getBounds(), velocity, &contact)) {
+        shape.setPosition(contact.point);
+        return false; // 子弹碰到障碍物，返回false表示需要删除
+    }
+
+    shape.move(velocity);
+    return true;
+}
+
+void Bullet::writeState(ByteWriter& writer) const {
+    writer.writeFloat(shape.getPosition().x);
+    writer.writeFloat(shape.getPosition().y);
+    writer.writeFloat(velocity.x);
+    writer.writeFloat(velocity.y);
+    writer.writeU8(isPlayerBullet ? 1 : 0);
+}
+
+bool Bullet::readState(ByteReader& reader) {
+    float x, y;
+    unsigned char fromPlayer;
+    if (!reader.readFloat(x) || !reader.readFloat(y) || !reader.readFloat(velocity.x) ||
+        !reader.readFloat(velocity.y) || !reader.readU8(fromPlayer)) {
+        return false;
+    }
+    isPlayerBullet = fromPlayer != 0;
+    shape.setPosition(x, y);
+    shape.setFillColor(isPlayerBullet ? sf::Color::Cyan : sf::Color::Yellow);
+    return true;
+}
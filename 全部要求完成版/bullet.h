@@ -0,0 +1,37 @@
+#ifndef BULLET_H
+#define BULLET_H
+
+#include "obstacle.h"
+
+class ByteWriter;
+class ByteReader;
+
+// 子弹类
+class Bullet {
+public:
+    static constexpr float SIZE = 5.f;            // 子弹的边长
+    static constexpr float DEFAULT_SPEED = 5.f;   // 每个逻辑帧的位移
+
+    Bullet(const sf::Vector2f& startPos, const sf::Vector2f& target, bool isPlayerBullet = false, float speed = DEFAULT_SPEED);
+
+    // 沿这一帧的位移做扫掠检测，速度再快也不会穿过障碍物。
+    // 返回false表示子弹碰到障碍物，需要删除 (子弹停在接触点)
+    bool move(const ObstacleGrid& obstacles);
+
+    sf::RectangleShape getShape() const { return shape; }
+    sf::Color getColor() const { return shape.getFillColor(); }
+    sf::FloatRect getBounds() const { return sf::FloatRect(shape.getPosition(), shape.getSize()); }
+    sf::Vector2f getVelocity() const { return velocity; }   // 每个逻辑帧的位移
+    bool isFromPlayer() const { return isPlayerBullet; }
+
+    // 存档：位置、速度和来源
+    void writeState(ByteWriter& writer) const;
+    bool readState(ByteReader& reader);
+
+private:
+    sf::RectangleShape shape;
+    sf::Vector2f velocity;
+    bool isPlayerBullet;
+};
+
+#endif // BULLET_H
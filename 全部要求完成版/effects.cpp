@@ -0,0 +1,46 @@
+#include "effects.h"
+#include <cmath>
+
+void emitTeleportEffect(ParticlePool& particles, const sf::Vector2f& position) {
+    const float radius = 2.f;
+    for (int i = 0; i < 12; ++i) {
+        // 设置粒子的初始速度（向外扩散的圆形pattern）
+        float angle = (i * 30.0f) * 3.14159f / 180.0f; // 每30度一个粒子
+        sf::Vector2f velocity(std::cos(angle) * 3.0f, std::sin(angle) * 3.0f);
+        particles.emit(position + sf::Vector2f(radius, radius), velocity, sf::Color::Cyan, 20.f, radius);
+    }
+}
+
+void emitDeathEffect(ParticlePool& particles, const sf::Vector2f& position, const sf::Color& color, Rng& rng) {
+    const float radius = 3.f;
+    for (int i = 0; i < 8; ++i) {
+        // 随机速度方向
+        float angle = (i * 45.0f) * 3.14159f / 180.0f; // 每45度一个粒子
+        sf::Vector2f velocity;
+        velocity.x = std::cos(angle) * (2.0f + rng.nextInt(3));
+        velocity.y = std::sin(angle) * (2.0f + rng.nextInt(3));
+        // 减速效果
+        particles.emit(position + sf::Vector2f(radius, radius), velocity, color, 30.f, radius, 0.95f);
+    }
+}
+
+void emitMenuParticle(ParticlePool& particles, const sf::Vector2f& position, Rng& rng) {
+    // 随机速度
+    float angle = static_cast<float>(rng.nextInt(360)) * 3.14159f / 180.f;
+    float speed = 0.5f + static_cast<float>(rng.nextInt(100)) / 100.f * 2.0f;
+    sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
+
+    // 随机颜色 - 使用蓝色和紫色的渐变
+    int r = 50 + rng.nextInt(100);
+    int g = 50 + rng.nextInt(150);
+    int b = 200 + rng.nextInt(55);
+    sf::Color color(r, g, b, 200);
+
+    // 随机生命周期 (3-5秒，按每秒60帧)
+    float lifetime = (3.0f + static_cast<float>(rng.nextInt(200)) / 100.f) * 60.f;
+
+    // 随机大小
+    float size = 1.0f + static_cast<float>(rng.nextInt(30)) / 10.f;
+
+    particles.emit(position, velocity, color, lifetime, size);
+}
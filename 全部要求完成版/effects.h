@@ -0,0 +1,19 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <SFML/Graphics.hpp>
+#include "rng.h"
+#include "particles.h"
+
+// 各种特效都是向粒子池发射一组粒子
+
+// 传送特效：12个青色粒子向四周扩散，持续20帧
+void emitTeleportEffect(ParticlePool& particles, const sf::Vector2f& position);
+
+// 死亡特效：8个怪物颜色的粒子向四周飞散并减速，持续30帧
+void emitDeathEffect(ParticlePool& particles, const sf::Vector2f& position, const sf::Color& color, Rng& rng);
+
+// 菜单背景粒子：随机方向、蓝紫色、持续3-5秒
+void emitMenuParticle(ParticlePool& particles, const sf::Vector2f& position, Rng& rng);
+
+#endif // EFFECTS_H
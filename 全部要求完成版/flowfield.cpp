@@ -0,0 +1,139 @@
+#include "flowfield.h"
+#include <algorithm>
+#include <cmath>
+
+// 8个相邻格子，前4个为上下左右
+static const int neighborDx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int neighborDy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+FlowField::FlowField() : cols(0), rows(0), stride(0), targetCell(-1) {
+    for (int k = 0; k < 8; ++k) {
+        neighborOffset[k] = 0;
+    }
+}
+
+void FlowField::build(const ObstacleGrid& obstacles, const sf::FloatRect& area) {
+    origin = sf::Vector2f(area.left, area.top);
+    cols = static_cast<int>(std::ceil(area.width / CELL_SIZE));
+    rows = static_cast<int>(std::ceil(area.height / CELL_SIZE));
+    // 四周多留一圈不可通行的格子，搜索时不用检查越界
+    stride = cols + 2;
+    walkable.assign(stride * (rows + 2), 0);
+    queue.reserve(stride * (rows + 2));
+    for (int k = 0; k < 8; ++k) {
+        neighborOffset[k] = neighborDy[k] * stride + neighborDx[k];
+    }
+
+    // 先按区域边界标记放得下怪物的格子
+    const float half = AGENT_SIZE / 2.f;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            float cx = origin.x + (col + 0.5f) * CELL_SIZE;
+            float cy = origin.y + (row + 0.5f) * CELL_SIZE;
+            walkable[(row + 1) * stride + col + 1] = cx - half >= area.left && cy - half >= area.top &&
+                cx + half <= area.left + area.width && cy + half <= area.top + area.height;
+        }
+    }
+
+    // 再逐个障碍物去掉碰到它的格子：怪物放在格子中心时与障碍物相交，
+    // 等价于格子中心落在障碍物向四周扩大半个怪物后的范围内 (不含边)
+    nearby.clear();
+    obstacles.query(area, nearby);
+    for (const sf::FloatRect& bounds : nearby) {
+        float left = bounds.left - half;
+        float top = bounds.top - half;
+        float right = bounds.left + bounds.width + half;
+        float bottom = bounds.top + bounds.height + half;
+        int col0 = std::max(0, static_cast<int>(std::floor((left - origin.x) / CELL_SIZE)));
+        int row0 = std::max(0, static_cast<int>(std::floor((top - origin.y) / CELL_SIZE)));
+        int col1 = std::min(cols - 1, static_cast<int>(std::floor((right - origin.x) / CELL_SIZE)));
+        int row1 = std::min(rows - 1, static_cast<int>(std::floor((bottom - origin.y) / CELL_SIZE)));
+        for (int row = row0; row <= row1; ++row) {
+            float cy = origin.y + (row + 0.5f) * CELL_SIZE;
+            if (cy <= top || cy >= bottom) {
+                continue;
+            }
+            for (int col = col0; col <= col1; ++col) {
+                float cx = origin.x + (col + 0.5f) * CELL_SIZE;
+                if (cx > left && cx < right) {
+                    walkable[(row + 1) * stride + col + 1] = 0;
+                }
+            }
+        }
+    }
+
+    // 障碍物变了，下次设置目标时必须重新搜索
+    targetCell = -1;
+    distance.assign(walkable.size(), -1);
+}
+
+bool FlowField::setTarget(const sf::Vector2f& target) {
+    int cell = cellIndex(target);
+    if (cell == targetCell) {
+        return false;
+    }
+    targetCell = cell;
+    search();
+    return true;
+}
+
+bool FlowField::nextWaypoint(const sf::Vector2f& position, sf::Vector2f& waypoint) const {
+    int cell = cellIndex(position);
+    if (cell < 0 || distance[cell] <= 0) {
+        return false;
+    }
+
+    // 选距离最小的相邻格子 (斜向要求两边的格子都可到达，避免擦着障碍物的角走)
+    int best = -1;
+    int bestDistance = distance[cell];
+    for (int k = 0; k < 8; ++k) {
+        int neighbor = cell + neighborOffset[k];
+        if (distance[neighbor] < 0 || distance[neighbor] >= bestDistance) {
+            continue;
+        }
+        if (k >= 4 && (distance[cell + neighborDx[k]] < 0 || distance[cell + neighborDy[k] * stride] < 0)) {
+            continue;
+        }
+        best = neighbor;
+        bestDistance = distance[neighbor];
+    }
+    if (best < 0) {
+        return false;
+    }
+
+    waypoint.x = origin.x + (best % stride - 1 + 0.5f) * CELL_SIZE;
+    waypoint.y = origin.y + (best / stride - 1 + 0.5f) * CELL_SIZE;
+    return true;
+}
+
+int FlowField::cellIndex(const sf::Vector2f& position) const {
+    int col = static_cast<int>(std::floor((position.x - origin.x) / CELL_SIZE));
+    int row = static_cast<int>(std::floor((position.y - origin.y) / CELL_SIZE));
+    if (col < 0 || col >= cols || row < 0 || row >= rows) {
+        return -1;
+    }
+    return (row + 1) * stride + col + 1;
+}
+
+void FlowField::search() {
+    std::fill(distance.begin(), distance.end(), -1);
+    if (targetCell < 0) {
+        return;
+    }
+
+    // 从目标格子出发按上下左右做广度优先搜索 (目标格子总是当作可通行)
+    queue.clear();
+    distance[targetCell] = 0;
+    queue.push_back(targetCell);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue[head];
+        int next = distance[cell] + 1;
+        for (int k = 0; k < 4; ++k) {
+            int neighbor = cell + neighborOffset[k];
+            if (walkable[neighbor] && distance[neighbor] < 0) {
+                distance[neighbor] = next;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
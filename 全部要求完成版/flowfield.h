@@ -0,0 +1,44 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "game.h"
+#include "obstacle.h"
+#include <vector>
+
+// 流场寻路：把一块区域分成小格子，从目标所在格子做一次广度优先搜索得到每个格子到目标的步数。
+// 所有追击的怪物共用，每只怪物只需查看所在格子周围8个格子。
+// 地图很大，流场只覆盖玩家附近的区域，区域外的怪物直接朝目标走
+class FlowField {
+public:
+    static const int CELL_SIZE = 20;
+    static const int AGENT_SIZE = 30;   // 怪物的尺寸，格子中心放得下一只怪物才算可通行
+
+    FlowField();
+
+    // 障碍物或覆盖区域变化时重新计算可通行的格子 (area 应在地图内)
+    void build(const ObstacleGrid& obstacles, const sf::FloatRect& area);
+
+    // 目标所在格子变化时才重新搜索，返回是否重新计算了
+    bool setTarget(const sf::Vector2f& target);
+
+    // 从 position (中心点) 出发应该走向的下一个格子的中心；
+    // 已经在目标格子、所在格子不可通行或无法到达时返回 false
+    bool nextWaypoint(const sf::Vector2f& position, sf::Vector2f& waypoint) const;
+
+private:
+    sf::Vector2f origin;          // 覆盖区域的左上角
+    int cols;
+    int rows;
+    int stride;                   // 每行的格子数 (含两侧边框)
+    int neighborOffset[8];        // 相邻格子的下标偏移
+    std::vector<char> walkable;
+    std::vector<int> distance;    // 到目标格子的步数，-1 表示无法到达
+    std::vector<int> queue;
+    std::vector<sf::FloatRect> nearby;   // build 时区域内的障碍物
+    int targetCell;
+
+    int cellIndex(const sf::Vector2f& position) const;
+    void search();
+};
+
+#endif // FLOWFIELD_H
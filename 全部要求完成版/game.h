@@ -0,0 +1,15 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <SFML/Graphics.hpp>
+
+// 窗口尺寸 (界面按窗口坐标布局)
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 800;
+// 地图尺寸：比窗口大得多，摄像机跟随玩家滚动 (15个障碍物区块宽，出生点在中间区块的中心)
+const int MAP_WIDTH = 3840;
+const int MAP_HEIGHT = 3840;
+const int MAX_LEVEL = 3;
+const int PLAYER_MAX_HEALTH = 5;   // 玩家初始生命值
+
+#endif // GAME_H
@@ -0,0 +1,145 @@
+#include "jobs.h"
+#include <algorithm>
+
+static thread_local unsigned currentThreadIndex = 0;
+
+static unsigned defaultWorkerCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    unsigned maxWorkers = JobSystem::MAX_WORKERS;
+    return cores > 1 ? std::min(cores - 1, maxWorkers) : 0;
+}
+
+JobSystem& JobSystem::instance() {
+    static JobSystem jobs(defaultWorkerCount());
+    return jobs;
+}
+
+JobSystem::JobSystem(unsigned workerCount) : pending(0), stopping(false) {
+    startWorkers(workerCount);
+}
+
+JobSystem::~JobSystem() {
+    stopWorkers();
+}
+
+void JobSystem::setWorkerCount(unsigned workerCount) {
+    stopWorkers();
+    startWorkers(workerCount);
+}
+
+unsigned JobSystem::threadIndex() {
+    return currentThreadIndex;
+}
+
+void JobSystem::run(size_t count, size_t grain, RangeCallback callback, const void* context) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t blocks = (count + grain - 1) / grain;
+    if (workers.empty() || blocks == 1) {
+        callback(context, 0, count);
+        return;
+    }
+
+    Batch batch;
+    batch.callback = callback;
+    batch.context = context;
+    batch.remaining = blocks;
+
+    // 先登记任务数再入队，工作线程检查 pending 和进入等待之间不会漏掉唤醒
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pending += blocks;
+    }
+    // 块轮流放进各线程的队列，第一块放在调用者自己的队列里
+    const unsigned self = threadIndex() < queues.size() ? threadIndex() : 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        Queue& queue = queues[(self + b) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{ &batch, b * grain, std::min(count, (b + 1) * grain) });
+    }
+    wake.notify_all();
+
+    // 调用者一边等一边执行任务 (可能是别的线程偷剩下的)
+    while (batch.remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::runOne(unsigned self) {
+    Job job;
+    if (!takeJob(self, job)) {
+        return false;
+    }
+    job.batch->callback(job.batch->context, job.begin, job.end);
+    // 减到0之后 batch 可能马上被调用者销毁，不能再访问
+    job.batch->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool JobSystem::takeJob(unsigned self, Job& job) {
+    const size_t count = queues.size();
+    for (size_t k = 0; k < count; ++k) {
+        Queue& queue = queues[(self + k) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.head >= queue.jobs.size()) {
+            continue;
+        }
+        if (k == 0) {
+            job = queue.jobs[queue.head++];
+        }
+        else {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        }
+        if (queue.head >= queue.jobs.size()) {
+            queue.jobs.clear();
+            queue.head = 0;
+        }
+        pending--;
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    currentThreadIndex = index;
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || pending.load() > 0; });
+        if (stopping && pending.load() == 0) {
+            return;
+        }
+    }
+}
+
+void JobSystem::startWorkers(unsigned workerCount) {
+    unsigned maxWorkers = MAX_WORKERS;
+    workerCount = std::min(workerCount, maxWorkers);
+    stopping = false;
+    queues.clear();
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        queues.emplace_back();
+    }
+    for (unsigned i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+void JobSystem::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
@@ -0,0 +1,87 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 任务系统：固定数量的工作线程，每个线程 (包括调用 parallelFor 的线程) 有自己的任务队列，
+// 先做自己队列前面的任务，做完了再从别的队列后面偷任务。
+// parallelFor 把区间切成固定大小的块，块的划分与线程数无关，调用者也参与执行，全部做完才返回
+class JobSystem {
+public:
+    // 默认的工作线程数为 CPU 核数减1 (调用者自己也算一个)，最多 MAX_WORKERS 个
+    static const unsigned MAX_WORKERS = 15;
+
+    static JobSystem& instance();
+
+    explicit JobSystem(unsigned workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 重新创建工作线程 (0 表示所有任务都在调用者线程执行)，不能在 parallelFor 执行期间调用
+    void setWorkerCount(unsigned workerCount);
+    // 参与执行任务的线程数 (工作线程数 + 1)，也是每线程缓冲需要的数量
+    unsigned getThreadCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // 把 [0, count) 按每块 grain 个切开，对每块调用 body(begin, end)。
+    // 同时执行的块之间不能写同一份数据；需要追加的结果写到 threadIndex() 对应的每线程缓冲里
+    // 非工作线程的编号都是0，所以同一时间只能有一个非工作线程调用 parallelFor (游戏中是模拟线程)
+    template <typename Function>
+    void parallelFor(size_t count, size_t grain, const Function& body) {
+        run(count, grain, &invoke<Function>, &body);
+    }
+
+    // 当前线程的编号：工作线程从1开始，其他线程 (主线程) 为0
+    static unsigned threadIndex();
+
+private:
+    typedef void (*RangeCallback)(const void* context, size_t begin, size_t end);
+
+    // 一次 parallelFor 调用，remaining 为还没做完的块数
+    struct Batch {
+        RangeCallback callback;
+        const void* context;
+        std::atomic<size_t> remaining;
+    };
+
+    struct Job {
+        Batch* batch;
+        size_t begin;
+        size_t end;
+    };
+
+    // 自己从 head 往后取，别的线程从末尾偷；取空后清零复用内存
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Job> jobs;
+        size_t head = 0;
+    };
+
+    std::deque<Queue> queues;          // 下标与 threadIndex() 相同
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending;       // 已经放进队列、还没被取走的任务数
+    bool stopping;
+
+    template <typename Function>
+    static void invoke(const void* context, size_t begin, size_t end) {
+        (*static_cast<const Function*>(context))(begin, end);
+    }
+
+    void run(size_t count, size_t grain, RangeCallback callback, const void* context);
+    bool runOne(unsigned self);
+    bool takeJob(unsigned self, Job& job);
+    void workerLoop(unsigned index);
+    void startWorkers(unsigned workerCount);
+    void stopWorkers();
+};
+
+#endif // JOBS_H
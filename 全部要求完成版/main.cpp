@@ -1,1004 +1,220 @@
-#include <SFML/Graphics.hpp>
+#include "world.h"
+#include "simthread.h"
+#include "replay.h"
+#include "saveservice.h"
+#include "render.h"
+#include "resources.h"
+#include "profiler.h"
+#include "jobs.h"
 #include <iostream>
 #include <vector>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <random>
 
-// ͼߴ (Ȼ߽)
-const int MAP_WIDTH = 800;
-const int MAP_HEIGHT = 800;
-const int MAX_LEVEL = 3;
-
-// 浵ṹ
-struct GameSave {
-    int playerType;  // 0: ս, 1: Զ
-    int health;
-    int currentLevel;
-    int score;
-    bool exists;     // Ǹô浵λǷڴ浵
-
-    GameSave() : playerType(0), health(5), currentLevel(1), score(0), exists(false) {}
-};
-
-// ȡ浵
-std::vector<GameSave> loadSaves() {
-    std::vector<GameSave> saves(3);  // 3浵λ
-    for (int i = 0; i < 3; i++) {
-        std::stringstream ss;
-        ss << "save" << i + 1 << ".dat";
-        std::ifstream file(ss.str(), std::ios::binary);
-        if (file.is_open()) {
-            file.read(reinterpret_cast<char*>(&saves[i]), sizeof(GameSave));
-            saves[i].exists = true;
-            file.close();
-        }
-    }
-    return saves;
-}
-
-// 浵
-void saveGame(const GameSave& save, int slot) {
-    std::stringstream ss;
-    ss << "save" << slot + 1 << ".dat";
-    std::ofstream file(ss.str(), std::ios::binary);
-    if (file.is_open()) {
-        file.write(reinterpret_cast<const char*>(&save), sizeof(GameSave));
-        file.close();
-    }
-}
-
-// ɾ浵
-void deleteSave(int slot) {
-    std::stringstream ss;
-    ss << "save" << slot + 1 << ".dat";
-    std::remove(ss.str().c_str());
-}
-
-// ײ⺯
-bool isCollision(const sf::RectangleShape& rect1, const sf::RectangleShape& rect2) {
-    return rect1.getGlobalBounds().intersects(rect2.getGlobalBounds());
+// 每局的随机种子 (同一种子可以复现整局游戏)
+uint64_t makeRunSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(time(nullptr)) << 32) ^ (static_cast<uint64_t>(device()) << 16) ^ device();
 }
 
-// ϰ
-class Obstacle {
-public:
-    Obstacle(float x, float y, float width, float height) {
-        shape.setPosition(x, y);
-        shape.setSize(sf::Vector2f(width, height));
-        shape.setFillColor(sf::Color::White);
-    }
-
-    const sf::RectangleShape& getShape() const {
-        return shape;
-    }
-
-    bool intersects(const sf::RectangleShape& other) const {
-        return shape.getGlobalBounds().intersects(other.getGlobalBounds());
-    }
-
-private:
-    sf::RectangleShape shape;
-};
-
-// ϰĺ
-std::vector<Obstacle> generateObstacles(int level) {
-    std::vector<Obstacle> obstacles;
-    int numObstacles = 5 + level * 2; // ÿϰ
-
-    for (int i = 0; i < numObstacles; ++i) {
-        float width = 30.0f + (rand() % 70); // 30-100
-        float height = 30.0f + (rand() % 70); // 30-100߶
-        float x = rand() % (MAP_WIDTH - static_cast<int>(width));
-        float y = rand() % (MAP_HEIGHT - static_cast<int>(height));
-
-        // ʱϰڼ
-        Obstacle obstacle(x, y, width, height);
-
-        // Ƿҳص
-        sf::RectangleShape spawnArea;
-        spawnArea.setSize(sf::Vector2f(100, 100));
-        spawnArea.setPosition(350, 350);
-
-        // صλ
-        if (obstacle.intersects(spawnArea)) {
-            --i;
-            continue;
-        }
-
-        // Ƿϰص
-        bool overlaps = false;
-        for (const auto& existing : obstacles) {
-            if (obstacle.intersects(existing.getShape())) {
-                overlaps = true;
-                break;
-            }
-        }
+// 游戏进行中每隔多少逻辑帧自动存档一次 (约5秒)，只追加有变化的块
+const unsigned long long AUTOSAVE_TICKS = 300;
 
-        if (!overlaps) {
-            obstacles.push_back(obstacle);
-        }
-        else {
-            --i; // 
-        }
+// 用读出的存档开始游戏：新格式恢复完整快照，旧格式按保存的关卡、分数和生命重新生成关卡
+bool restoreGame(World& world, const WorldSnapshot& snapshot, const SaveSummary& summary) {
+    if (!summary.legacy && world.readSnapshot(snapshot)) {
+        return true;
     }
-
-    return obstacles;
-}
-
-// Ƿκϰײ
-bool checkObstacleCollision(const sf::RectangleShape& object, const std::vector<Obstacle>& obstacles) {
-    for (const auto& obstacle : obstacles) {
-        if (obstacle.intersects(object)) {
-            return true;
-        }
+    // 旧格式的存档 (以及小地图版本没有障碍物区块种子的存档) 按保存的关卡重新开始
+    if (summary.exists) {
+        world.start(summary.playerType, summary.level, summary.score, summary.health, makeRunSeed());
+        return true;
     }
     return false;
 }
 
-// ɹ㣬֤ϰص
-sf::Vector2f generateMonsterSpawn(const sf::Vector2f& size, const std::vector<Obstacle>& obstacles) {
-    while (true) {
-        float x = rand() % (MAP_WIDTH - static_cast<int>(size.x));
-        float y = rand() % (MAP_HEIGHT - static_cast<int>(size.y));
-        sf::RectangleShape temp;
-        temp.setSize(size);
-        temp.setPosition(x, y);
-        bool overlap = false;
-        for (const auto& obs : obstacles) {
-            if (obs.intersects(temp)) {
-                overlap = true;
-                break;
-            }
+// 在游戏线程生成当前世界的快照，交给存档服务在后台写入
+void saveGame(const World& world, SaveService& saveService, int slot, bool delta) {
+    WorldSnapshot snapshot;
+    world.writeSnapshot(snapshot);
+    saveService.save(slot, std::move(snapshot), delta, [delta](bool ok) {
+        if (!ok) {
+            std::cerr << (delta ? "Error: Autosave failed" : "Error: Failed to save game") << std::endl;
         }
-        if (!overlap) return sf::Vector2f(x, y);
-    }
+    });
 }
 
-// һ
-class Player {
-public:
-    Player() {
-        shape.setSize(sf::Vector2f(50, 50));
-        shape.setPosition(375, 375);
-        shape.setFillColor(sf::Color::Green);  // ҷΪɫ
-        health = 5;
-        invincibilityFrames = 0;
-        shootCooldown = 0;
-    }
-
-    virtual ~Player() = default;
-
-    virtual void move(float dx, float dy, const std::vector<Obstacle>& obstacles) {
-        sf::Vector2f newPos = shape.getPosition() + sf::Vector2f(dx, dy);
-        sf::RectangleShape newShape = shape;
-        newShape.setPosition(newPos);
-
-        // λǷϰײ
-        if (!checkObstacleCollision(newShape, obstacles)) {
-            if (newPos.x >= 0 && newPos.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH)) {
-                shape.move(dx, 0);
-            }
-            if (newPos.y >= 0 && newPos.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT)) {
-                shape.move(0, dy);
-            }
-            updateSprite();
-        }
-    }
-
-    sf::RectangleShape getShape() const {
-        return shape;
-    }
-
-    sf::Sprite getSprite() const {
-        return sprite;
-    }
-
-    int getHealth() const {
-        return health;
-    }
-
-    void reduceHealth() {
-        if (health > 0 && invincibilityFrames == 0) {
-            health--;
-            invincibilityFrames = 30;
-        }
-    }
-
-    void updateInvincibility() {
-        if (invincibilityFrames > 0) {
-            invincibilityFrames--;
-        }
-    }
-
-    virtual void reset() {
-        shape.setPosition(375, 375);
-        updateSprite();
-        health = 5;
-        invincibilityFrames = 0;
-    }
-
-    virtual bool canShoot() const {
-        return shootCooldown == 0;
-    }
-
-    virtual void setShootCooldown() {
-        shootCooldown = 15;
-    }
-
-    virtual void updateShootCooldown() {
-        if (shootCooldown > 0) {
-            shootCooldown--;
-        }
-    }
-
-    void setHealth(int newHealth) {
-        health = newHealth;
-    }
-
-protected:
-    sf::RectangleShape shape;
-    sf::Sprite sprite;
-    sf::Texture texture;
-    int health;
-    int invincibilityFrames;
-    int shootCooldown;
-
-    void updateSprite() {
-        sprite.setPosition(shape.getPosition());
-    }
-};
-
-// ս
-class MeleePlayer : public Player {
-public:
-    MeleePlayer() : Player() {
-        if (!texture.loadFromFile("resources/player/l11.png")) {
-            std::cerr << "Error: Failed to load melee player texture!" << std::endl;
-        }
-        sprite.setTexture(texture, true);  // trueʾԭʼʽ
-        sprite.setPosition(shape.getPosition());
-
-        attackRange = 100.0f;  // ӹΧ
-        sweepAnimating = false;
-        sweepAngle = 0.f;
-        sweepParticles.clear();
-    }
-
-    float getAttackRange() const { return attackRange; }
-    void setShootCooldown() override {
-        shootCooldown = 20;
-    }
-
-    void startSweep() {
-        sweepAnimating = true;
-        sweepAngle = 0.f;
-        sweepParticles.clear();
-    }
-
-    void updateSweep() {
-        if (sweepAnimating) {
-            sweepAngle += 24.f;  // ԭеתٶ
-
-            // µ
-            if (rand() % 2 == 0) {  // 50%ĸ
-                float currentAngle = (-90.f + sweepAngle) * 3.14159f / 180.f;
-                sf::Vector2f center = shape.getPosition() + shape.getSize() / 2.f;
-                float randRadius = attackRange * (0.6f + (rand() % 40) / 100.0f);  // 60%-100%Χ
-
-                SweepParticle particle;
-                particle.position = center + sf::Vector2f(
-                    std::cos(currentAngle) * randRadius,
-                    std::sin(currentAngle) * randRadius
-                );
-                particle.color = sf::Color(100, 200, 255, 255);  // ǳɫ
-                particle.lifetime = 10;  // ӳ10֡
-                sweepParticles.push_back(particle);
-            }
-
-            // 
-            for (auto& particle : sweepParticles) {
-                particle.lifetime--;
-                particle.color.a = static_cast<sf::Uint8>((particle.lifetime / 10.0f) * 255);
-            }
-
-            // Ƴʧ
-            sweepParticles.erase(
-                std::remove_if(sweepParticles.begin(), sweepParticles.end(),
-                    [](const SweepParticle& p) { return p.lifetime <= 0; }),
-                sweepParticles.end()
-            );
-
-            if (sweepAngle >= 360.f) {
-                sweepAnimating = false;
-                sweepAngle = 0.f;
-                sweepParticles.clear();
-            }
-        }
-    }
-
-    void drawSweepEffect(sf::RenderWindow& window) const {
-        if (sweepAnimating) {
-            // ҪЧ
-            float playerSize = shape.getSize().x;
-            float outerRadius = attackRange;
-            float innerRadius = playerSize * 0.8f;
-            sf::Vector2f center = shape.getPosition() + shape.getSize() / 2.f;
-
-            // ЧĶ
-            for (float r = innerRadius; r <= outerRadius; r += (outerRadius - innerRadius) / 5.0f) {
-                int segments = 60;
-                float angleStep = sweepAngle / segments;
-                sf::VertexArray ring(sf::TriangleStrip, (segments + 1) * 2);
-
-                for (int i = 0; i <= segments; ++i) {
-                    float angle = -90.f + i * angleStep;
-                    float rad = angle * 3.14159f / 180.f;
-                    float alpha = 1.0f - ((r - innerRadius) / (outerRadius - innerRadius));
-                    sf::Uint8 alphaValue = static_cast<sf::Uint8>(alpha * 128);  // ͸Ƚ͵128
-
-                    // Ȧ
-                    ring[i * 2].position = center + sf::Vector2f(std::cos(rad) * (r + 5), std::sin(rad) * (r + 5));
-                    ring[i * 2].color = sf::Color(100, 200, 255, alphaValue);  // ǳɫ
-
-                    // Ȧ
-                    ring[i * 2 + 1].position = center + sf::Vector2f(std::cos(rad) * r, std::sin(rad) * r);
-                    ring[i * 2 + 1].color = sf::Color(100, 200, 255, alphaValue);
-                }
-                window.draw(ring);
-            }
-
-            // 
-            for (const auto& particle : sweepParticles) {
-                sf::CircleShape particleShape(3);  // ӴСΪ3
-                particleShape.setFillColor(particle.color);
-                particleShape.setPosition(particle.position);
-                particleShape.setOrigin(1.5f, 1.5f);  // ԭΪ
-                window.draw(particleShape);
-            }
-        }
-    }
-
-    bool isSweeping() const { return sweepAnimating; }
-    float getSweepAngle() const { return sweepAngle; }
-
-private:
-    float attackRange;
-    bool sweepAnimating;
-    float sweepAngle;
-
-    // ӽṹ
-    struct SweepParticle {
-        sf::Vector2f position;
-        sf::Color color;
-        int lifetime;
-    };
-    std::vector<SweepParticle> sweepParticles;
-};
-
-// Զ
-class RangedPlayer : public Player {
-public:
-    RangedPlayer() : Player() {
-        if (!texture.loadFromFile("resources/player/tales1.png")) {
-            std::cerr << "Error: Failed to load ranged player texture!" << std::endl;
-        }
-        sprite.setTexture(texture, true);  // trueʾԭʼʽ
-        sprite.setPosition(shape.getPosition());
-
-        bulletSpeed = 7.0f;
-    }
-
-    float getBulletSpeed() const {
-        return bulletSpeed;
-    }
-
-    void setShootCooldown() override {
-        shootCooldown = 20;
-    }
-
-private:
-    float bulletSpeed;
-};
-
-// ս
-class MeleeMonster {
-public:
-    MeleeMonster(const std::vector<Obstacle>& obstacles) {
-        shape.setSize(sf::Vector2f(30, 30));
-        shape.setPosition(generateMonsterSpawn(shape.getSize(), obstacles));
-    }
-
-    // ĳǷƶ
-    bool canMove(const sf::Vector2f& direction, const std::vector<Obstacle>& obstacles) {
-        sf::Vector2f newPos = shape.getPosition() + direction;
-        sf::RectangleShape newShape = shape;
-        newShape.setPosition(newPos);
-
-        return !checkObstacleCollision(newShape, obstacles) &&
-            newPos.x >= 0 && newPos.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH) &&
-            newPos.y >= 0 && newPos.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT);
-    }
+// 在屏幕上随机位置添加一个菜单背景粒子
+void addRandomMenuParticle(ParticlePool& particles, Rng& rng) {
+    float x = static_cast<float>(rng.nextInt(WINDOW_WIDTH));
+    float y = static_cast<float>(rng.nextInt(WINDOW_HEIGHT));
+    emitMenuParticle(particles, sf::Vector2f(x, y), rng);
+}
 
-    // Ѱƶ
-    sf::Vector2f findAlternativeDirection(const sf::Vector2f& originalDir, const std::vector<Obstacle>& obstacles) {
-        // 8ͬķ
-        const float angles[8] = { 45, -45, 90, -90, 135, -135, 180, 0 };  // Ƕ
+// 启动时每个绘制帧最多花在上传贴图上的时间
+const sf::Time TEXTURE_UPLOAD_BUDGET = sf::milliseconds(4);
 
-        for (float angle : angles) {
-            // ǶתΪ
-            float radian = angle * 3.14159f / 180.0f;
+// F4 导出的帧耗时记录
+const char* TRACE_FILE = "trace.json";
 
-            // µķ
-            sf::Vector2f newDir;
-            newDir.x = std::cos(radian) * originalDir.x - std::sin(radian) * originalDir.y;
-            newDir.y = std::sin(radian) * originalDir.x + std::cos(radian) * originalDir.y;
+// 每局结束 (或退出) 时录像写入的文件
+const char* REPLAY_FILE = "replay.dat";
 
-            // ׼
-            float length = std::sqrt(newDir.x * newDir.x + newDir.y * newDir.y);
-            if (length > 0) {
-                newDir /= length;
-            }
+// 无界面运行：远程玩家绕圈移动并定时射击最近的怪物，关卡结束后继续下一关或重开，
+// 最后输出每秒逻辑帧数 (用于平衡和回归测试)。同一种子的结果完全相同
+int runHeadless(unsigned long long ticks, uint64_t seed) {
+    World world;
+    int runs = 0;
+    world.start(1, 1, 0, PLAYER_MAX_HEALTH, Rng::deriveSeed(seed, runs++));
+    InputFrame input;
+    int levelsCleared = 0;
+    int deaths = 0;
 
-            // ·Ƿ
-            if (canMove(newDir * 5.0f, obstacles)) {
-                return newDir;
-            }
+    sf::Clock clock;
+    for (unsigned long long i = 0; i < ticks; ++i) {
+        if (world.getStatus() == WorldStatus::LEVEL_COMPLETE) {
+            levelsCleared++;
+            world.nextLevel();
         }
-
-        return sf::Vector2f(0, 0); // ûҵз򣬷
-    }
-
-    virtual void moveTowards(const sf::Vector2f& target, const std::vector<Obstacle>& obstacles) {
-        sf::Vector2f direction = target - shape.getPosition();
-        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-
-        if (length > 0) {
-            direction /= length;
-            sf::Vector2f newPos = shape.getPosition() + direction * 1.0f;
-            sf::RectangleShape newShape = shape;
-            newShape.setPosition(newPos);
-
-            if (!checkObstacleCollision(newShape, obstacles)) {
-                // ûϰƶ
-                if (newPos.x >= 0 && newPos.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH)) {
-                    shape.move(direction.x * 1.0f, 0);
-                }
-                if (newPos.y >= 0 && newPos.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT)) {
-                    shape.move(0, direction.y * 1.0f);
-                }
+        else if (world.getStatus() != WorldStatus::RUNNING) {
+            if (world.getStatus() == WorldStatus::VICTORY) {
+                levelsCleared++;
             }
             else {
-                // ϰѰ·
-                sf::Vector2f alternativeDir = findAlternativeDirection(direction, obstacles);
-                if (alternativeDir.x != 0 || alternativeDir.y != 0) {
-                    if (shape.getPosition().x + alternativeDir.x >= 0 &&
-                        shape.getPosition().x + alternativeDir.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH)) {
-                        shape.move(alternativeDir.x * 1.0f, 0);
-                    }
-                    if (shape.getPosition().y + alternativeDir.y >= 0 &&
-                        shape.getPosition().y + alternativeDir.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT)) {
-                        shape.move(0, alternativeDir.y * 1.0f);
-                    }
-                }
-            }
-        }
-    }
-
-    sf::RectangleShape getShape() const {
-        return shape;
-    }
-
-    bool isHit(const sf::RectangleShape& bullet) const {
-        return isCollision(shape, bullet);
-    }
-
-protected:
-    sf::RectangleShape shape;
-};
-
-// Ч
-class TeleportEffect {
-public:
-    TeleportEffect(const sf::Vector2f& position) {
-        this->position = position;
-        timer = 0;
-        maxTimer = 20; // 20֡ʱ
-
-        // 
-        for (int i = 0; i < 12; ++i) {
-            sf::CircleShape particle(2);
-            particle.setFillColor(sf::Color::Cyan);
-            particle.setPosition(position);
-            particles.push_back(particle);
-
-            // ӵĳʼٶȣɢԲpattern
-            float angle = (i * 30.0f) * 3.14159f / 180.0f; // ÿ30һ
-            sf::Vector2f velocity;
-            velocity.x = std::cos(angle) * 3.0f;
-            velocity.y = std::sin(angle) * 3.0f;
-            velocities.push_back(velocity);
-        }
-    }
-
-    bool update() {
-        timer++;
-
-        // λú͸
-        float alpha = 1.0f - (static_cast<float>(timer) / maxTimer);
-        sf::Uint8 alphaValue = static_cast<sf::Uint8>(alpha * 255);
-
-        for (size_t i = 0; i < particles.size(); ++i) {
-            particles[i].move(velocities[i]);
-            sf::Color particleColor = sf::Color::Cyan;
-            particleColor.a = alphaValue;
-            particles[i].setFillColor(particleColor);
-        }
-
-        return timer < maxTimer;
-    }
-
-    void draw(sf::RenderWindow& window) const {
-        for (const auto& particle : particles) {
-            window.draw(particle);
-        }
-    }
-
-private:
-    sf::Vector2f position;
-    std::vector<sf::CircleShape> particles;
-    std::vector<sf::Vector2f> velocities;
-    int timer;
-    int maxTimer;
-};
-
-// ɫս
-class BlueMeleeMonster : public MeleeMonster {
-public:
-    BlueMeleeMonster(const std::vector<Obstacle>& obstacles) : MeleeMonster(obstacles) {
-        shape.setFillColor(sf::Color::Blue);
-        teleportCooldown = 0;
-        isTeleporting = false;
-        teleportTimer = 0;
-        hasStartEffect = false;
-    }
-
-    void moveTowards(const sf::Vector2f& target, std::vector<TeleportEffect>& effects, const std::vector<Obstacle>& obstacles) {
-        if (isTeleporting) {
-            teleportTimer++;
-
-            if (!hasStartEffect) {
-                sf::Vector2f effectPos = shape.getPosition() + shape.getSize() / 2.f;
-                effects.emplace_back(effectPos);
-                hasStartEffect = true;
-            }
-
-            if (teleportTimer >= 90) {
-                sf::Vector2f newPos = target;
-                newPos.x -= shape.getSize().x / 2;
-                newPos.y -= shape.getSize().y / 2;
-
-                // 鴫ĿλǷϰײ
-                sf::RectangleShape newShape = shape;
-                newShape.setPosition(newPos);
-                if (!checkObstacleCollision(newShape, obstacles)) {
-                    shape.setPosition(newPos);
-                    sf::Vector2f effectPos = newPos + shape.getSize() / 2.f;
-                    effects.emplace_back(effectPos);
-                }
-
-                isTeleporting = false;
-                teleportTimer = 0;
-                teleportCooldown = 600;
-                hasStartEffect = false;
-            }
-            return;
-        }
-
-        if (teleportCooldown > 0) {
-            teleportCooldown--;
-        }
-        else if (rand() % 100 == 0) {
-            isTeleporting = true;
-            teleportTimer = 0;
-            hasStartEffect = false;
-        }
-
-        if (!isTeleporting) {
-            MeleeMonster::moveTowards(target, obstacles);
-        }
-    }
-
-private:
-    int teleportCooldown;
-    bool isTeleporting;
-    int teleportTimer;
-    bool hasStartEffect;
-};
-
-// ɫս
-class RedMeleeMonster : public MeleeMonster {
-public:
-    RedMeleeMonster(const std::vector<Obstacle>& obstacles) : MeleeMonster(obstacles) {
-        shape.setFillColor(sf::Color::Red);
-    }
-};
-
-// ɫս
-class YellowMeleeMonster : public MeleeMonster {
-public:
-    YellowMeleeMonster(const std::vector<Obstacle>& obstacles) : MeleeMonster(obstacles) {
-        shape.setFillColor(sf::Color::Yellow);
-    }
-};
-
-// Ч
-class DeathEffect {
-public:
-    DeathEffect(const sf::Vector2f& position, const sf::Color& color) {
-        this->position = position;
-        this->color = color;
-        timer = 0;
-        maxTimer = 30; // 30֡ʱ
-
-        // 
-        for (int i = 0; i < 8; ++i) {
-            sf::CircleShape particle(3);
-            particle.setFillColor(color);
-            particle.setPosition(position);
-            particles.push_back(particle);
-
-            // ٶȷ
-            float angle = (i * 45.0f) * 3.14159f / 180.0f; // ÿ45һ
-            sf::Vector2f velocity;
-            velocity.x = std::cos(angle) * (2.0f + rand() % 3);
-            velocity.y = std::sin(angle) * (2.0f + rand() % 3);
-            velocities.push_back(velocity);
-        }
-    }
-
-    bool update() {
-        timer++;
-
-        // λú͸
-        float alpha = 1.0f - (static_cast<float>(timer) / maxTimer);
-        sf::Uint8 alphaValue = static_cast<sf::Uint8>(alpha * 255);
-
-        for (size_t i = 0; i < particles.size(); ++i) {
-            particles[i].move(velocities[i]);
-            sf::Color particleColor = color;
-            particleColor.a = alphaValue;
-            particles[i].setFillColor(particleColor);
-
-            // Ч
-            velocities[i] *= 0.95f;
-        }
-
-        return timer < maxTimer;
-    }
-
-    void draw(sf::RenderWindow& window) const {
-        for (const auto& particle : particles) {
-            window.draw(particle);
-        }
-    }
-
-private:
-    sf::Vector2f position;
-    sf::Color color;
-    std::vector<sf::CircleShape> particles;
-    std::vector<sf::Vector2f> velocities;
-    int timer;
-    int maxTimer;
-};
-
-// ӵ (޸Ķ)
-class Bullet {
-public:
-    Bullet(const sf::Vector2f& startPos, const sf::Vector2f& target, bool isPlayerBullet = false) {
-        shape.setSize(sf::Vector2f(5, 5));
-        shape.setFillColor(isPlayerBullet ? sf::Color::Cyan : sf::Color::Yellow);
-        shape.setPosition(startPos);
-
-        sf::Vector2f direction = target - startPos;
-        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-        if (length > 0) {
-            direction /= length;
-            velocity = direction * 5.0f; // ӵٶ
-        }
-        this->isPlayerBullet = isPlayerBullet;
-    }
-
-    bool move(const std::vector<Obstacle>& obstacles) {
-        sf::Vector2f newPos = shape.getPosition() + velocity;
-        sf::RectangleShape newShape = shape;
-        newShape.setPosition(newPos);
-
-        // Ƿϰײ
-        if (checkObstacleCollision(newShape, obstacles)) {
-            return false; // ӵϰfalseʾҪɾ
-        }
-
-        shape.move(velocity);
-        return true;
-    }
-
-    sf::RectangleShape getShape() const {
-        return shape;
-    }
-
-    bool isFromPlayer() const {
-        return isPlayerBullet;
-    }
-
-private:
-    sf::RectangleShape shape;
-    sf::Vector2f velocity;
-    bool isPlayerBullet;
-};
-
-// Զ̹
-class RangedMonster {
-public:
-    RangedMonster(const std::vector<Obstacle>& obstacles) {
-        shape.setSize(sf::Vector2f(30, 30));
-        shape.setPosition(generateMonsterSpawn(shape.getSize(), obstacles));
-        shape.setFillColor(sf::Color::Magenta);
-        shootTimer = 0;
-    }
-
-    bool canMove(const sf::Vector2f& direction, const std::vector<Obstacle>& obstacles) {
-        sf::Vector2f newPos = shape.getPosition() + direction;
-        sf::RectangleShape newShape = shape;
-        newShape.setPosition(newPos);
-
-        return !checkObstacleCollision(newShape, obstacles) &&
-            newPos.x >= 0 && newPos.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH) &&
-            newPos.y >= 0 && newPos.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT);
-    }
-
-    sf::Vector2f findAlternativeDirection(const sf::Vector2f& originalDir, const std::vector<Obstacle>& obstacles) {
-        const float angles[8] = { 45, -45, 90, -90, 135, -135, 180, 0 };
-
-        for (float angle : angles) {
-            float radian = angle * 3.14159f / 180.0f;
-            sf::Vector2f newDir;
-            newDir.x = std::cos(radian) * originalDir.x - std::sin(radian) * originalDir.y;
-            newDir.y = std::sin(radian) * originalDir.x + std::cos(radian) * originalDir.y;
-
-            float length = std::sqrt(newDir.x * newDir.x + newDir.y * newDir.y);
-            if (length > 0) {
-                newDir /= length;
-            }
-
-            if (canMove(newDir * 5.0f, obstacles)) {
-                return newDir;
+                deaths++;
             }
+            world.start(1, 1, 0, PLAYER_MAX_HEALTH, Rng::deriveSeed(seed, runs++));
         }
 
-        return sf::Vector2f(0, 0);
-    }
-
-    void moveTowards(const sf::Vector2f& target, const std::vector<Obstacle>& obstacles) {
-        sf::Vector2f direction = target - shape.getPosition();
-        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
-
-        if (length > 0) {
-            direction /= length;
-            sf::Vector2f newPos = shape.getPosition() + direction * 0.8f;
-            sf::RectangleShape newShape = shape;
-            newShape.setPosition(newPos);
+        int phase = static_cast<int>(i / 30 % 4);
+        input.right = phase == 0;
+        input.down = phase == 1;
+        input.left = phase == 2;
+        input.up = phase == 3;
 
-            if (!checkObstacleCollision(newShape, obstacles)) {
-                if (newPos.x >= 0 && newPos.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH)) {
-                    shape.move(direction.x * 0.8f, 0);
-                }
-                if (newPos.y >= 0 && newPos.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT)) {
-                    shape.move(0, direction.y * 0.8f);
-                }
-            }
-            else {
-                sf::Vector2f alternativeDir = findAlternativeDirection(direction, obstacles);
-                if (alternativeDir.x != 0 || alternativeDir.y != 0) {
-                    if (shape.getPosition().x + alternativeDir.x >= 0 &&
-                        shape.getPosition().x + alternativeDir.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH)) {
-                        shape.move(alternativeDir.x * 0.8f, 0);
-                    }
-                    if (shape.getPosition().y + alternativeDir.y >= 0 &&
-                        shape.getPosition().y + alternativeDir.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT)) {
-                        shape.move(0, alternativeDir.y * 0.8f);
-                    }
+        const MonsterStore& monsters = world.getMonsters();
+        input.attack = i % 20 == 0 && !monsters.empty();
+        if (input.attack) {
+            sf::Vector2f center = world.getPlayer().getCenter();
+            float best = -1.f;
+            for (size_t m = 0; m < monsters.size(); ++m) {
+                sf::Vector2f d = monsters.getCenter(m) - center;
+                float dist = d.x * d.x + d.y * d.y;
+                if (best < 0.f || dist < best) {
+                    best = dist;
+                    input.target = monsters.getCenter(m);
                 }
             }
         }
-    }
-
-    void shoot(const sf::Vector2f& target, std::vector<Bullet>& bullets) {
-        shootTimer++;
-        if (shootTimer >= 60) {
-            bullets.emplace_back(shape.getPosition(), target);
-            shootTimer = 0;
-        }
-    }
 
-    sf::RectangleShape getShape() const {
-        return shape;
+        world.step(input);
     }
+    float seconds = clock.getElapsedTime().asSeconds();
 
-    bool isHit(const sf::RectangleShape& bullet) const {
-        return isCollision(shape, bullet);
+    std::cout << "seed: " << seed << ", ticks: " << ticks << ", levels cleared: " << levelsCleared << ", deaths: " << deaths << std::endl;
+    if (seconds > 0.f) {
+        std::cout << "ticks/s: " << static_cast<double>(ticks) / seconds << std::endl;
     }
-
-private:
-    sf::RectangleShape shape;
-    int shootTimer;
-};
-
-// ¿ʼϷ
-void restartGame(Player*& player, std::vector<BlueMeleeMonster>& blueMonsters,
-    std::vector<RedMeleeMonster>& redMonsters, std::vector<YellowMeleeMonster>& yellowMonsters,
-    std::vector<RangedMonster>& rangedMonsters, int& score, int& currentLevel, std::vector<Obstacle>& obstacles) {
-    delete player;
-    player = nullptr;
-    blueMonsters.clear();
-    redMonsters.clear();
-    yellowMonsters.clear();
-    rangedMonsters.clear();
-    obstacles.clear();
-    score = 0;
-    currentLevel = 1;
-    // ϰ
-    obstacles = generateObstacles(currentLevel);
+    return 0;
 }
 
-// һ
-void nextLevel(Player* player, std::vector<BlueMeleeMonster>& blueMonsters,
-    std::vector<RedMeleeMonster>& redMonsters, std::vector<YellowMeleeMonster>& yellowMonsters,
-    std::vector<RangedMonster>& rangedMonsters, int& score, int& currentLevel, std::vector<Obstacle>& obstacles) {
-    player->reset();
-    blueMonsters.clear();
-    redMonsters.clear();
-    yellowMonsters.clear();
-    rangedMonsters.clear();
-    score = 0;
-
-    if (currentLevel < MAX_LEVEL) {
-        currentLevel++;
+// 无界面全速重放录像，检查每帧的状态哈希，输出每秒逻辑帧数
+int runReplay(const std::string& path) {
+    Replay replay;
+    if (!loadReplay(replay, path)) {
+        std::cerr << "Error: Failed to load replay " << path << std::endl;
+        return 1;
     }
 
-    // µϰ
-    obstacles = generateObstacles(currentLevel);
+    World world;
+    ReplayPlayer replayPlayer;
+    replayPlayer.start(replay, world);
 
-    int baseCount = currentLevel + 1;
-    for (int i = 0; i < baseCount; ++i) {
-        blueMonsters.emplace_back(obstacles);
+    sf::Clock clock;
+    while (replayPlayer.step(world)) {
     }
-    for (int i = 0; i < baseCount; ++i) {
-        redMonsters.emplace_back(obstacles);
+    float seconds = clock.getElapsedTime().asSeconds();
+
+    std::cout << "seed: " << replay.seed << ", ticks: " << replayPlayer.getCursor() << "/" << replay.size() << std::endl;
+    if (seconds > 0.f) {
+        std::cout << "ticks/s: " << static_cast<double>(replayPlayer.getCursor()) / seconds << std::endl;
     }
-    for (int i = 0; i < baseCount; ++i) {
-        yellowMonsters.emplace_back(obstacles);
+    if (replayPlayer.getDesyncTick() >= 0) {
+        std::cout << "desync at tick " << replayPlayer.getDesyncTick() << std::endl;
+        return 2;
     }
-    for (int i = 0; i < baseCount; ++i) {
-        rangedMonsters.emplace_back(obstacles);
+    if (!replayPlayer.isFinished()) {
+        std::cout << "replay ended early" << std::endl;
+        return 2;
     }
+    std::cout << "replay ok" << std::endl;
+    return 0;
 }
 
-// ϵͳ
-class ParticleSystem {
-public:
-    struct Particle {
-        sf::Vector2f position;
-        sf::Vector2f velocity;
-        sf::Color color;
-        float lifetime;
-        float maxLifetime;
-        float size;
-    };
-
-    ParticleSystem(int maxParticles) : maxParticles(maxParticles) {
-        particles.reserve(maxParticles);
-    }
-
-    void addParticle(const sf::Vector2f& position) {
-        if (particles.size() >= maxParticles) return;
-
-        Particle p;
-        p.position = position;
-
-        // ٶ
-        float angle = static_cast<float>(rand() % 360) * 3.14159f / 180.f;
-        float speed = 0.5f + static_cast<float>(rand() % 100) / 100.f * 2.0f;
-        p.velocity = sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
-
-        // ɫ - ʹɫɫĽ
-        int r = 50 + rand() % 100;
-        int g = 50 + rand() % 150;
-        int b = 200 + rand() % 55;
-        p.color = sf::Color(r, g, b, 200);
-
-        // 
-        p.maxLifetime = 3.0f + static_cast<float>(rand() % 200) / 100.f;
-        p.lifetime = p.maxLifetime;
-
-        // С
-        p.size = 1.0f + static_cast<float>(rand() % 30) / 10.f;
-
-        particles.push_back(p);
-    }
-
-    void update(float deltaTime) {
-        for (auto it = particles.begin(); it != particles.end();) {
-            it->lifetime -= deltaTime;
-            if (it->lifetime <= 0) {
-                it = particles.erase(it);
-            }
-            else {
-                it->position += it->velocity;
-
-                // 뿪Ļһ߳
-                if (it->position.x < 0) it->position.x = MAP_WIDTH;
-                if (it->position.x > MAP_WIDTH) it->position.x = 0;
-                if (it->position.y < 0) it->position.y = MAP_HEIGHT;
-                if (it->position.y > MAP_HEIGHT) it->position.y = 0;
-
-                // ڼ٣͸
-                float alpha = it->lifetime / it->maxLifetime;
-                it->color.a = static_cast<sf::Uint8>(alpha * 200);
-
-                ++it;
-            }
-        }
-
-        // 
-        if (rand() % 5 == 0 && particles.size() < maxParticles) {
-            float x = static_cast<float>(rand() % MAP_WIDTH);
-            float y = static_cast<float>(rand() % MAP_HEIGHT);
-            addParticle(sf::Vector2f(x, y));
+int main(int argc, char* argv[]) {
+    // 无界面模式：main --headless <逻辑帧数> [种子] [工作线程数] (结果与线程数无关)
+    if (argc >= 3 && std::string(argv[1]) == "--headless") {
+        uint64_t seed = argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 1;
+        if (argc >= 5) {
+            JobSystem::instance().setWorkerCount(static_cast<unsigned>(std::atoi(argv[4])));
         }
+        return runHeadless(std::strtoull(argv[2], nullptr, 10), seed);
     }
-
-    void draw(sf::RenderWindow& window) const {
-        for (const auto& p : particles) {
-            sf::CircleShape shape(p.size);
-            shape.setFillColor(p.color);
-            shape.setPosition(p.position);
-            shape.setOrigin(p.size, p.size);
-            window.draw(shape);
-        }
+    // 无界面全速重放：main --replay <录像文件>
+    if (argc >= 3 && std::string(argv[1]) == "--replay") {
+        return runReplay(argv[2]);
     }
 
-private:
-    std::vector<Particle> particles;
-    int maxParticles;
-};
+    sf::Clock startupClock;   // 统计启动到第一帧和到资源全部加载完的时间
 
-int main() {
-    srand(static_cast<unsigned int>(time(nullptr)));
-
-    // 
+    // 加载字体 (存档选择界面的文字马上就要用，字形在绘制时才生成，打开字体文件很快)
     sf::Font font;
     if (!font.loadFromFile("arial.ttf")) {
         std::cerr << "ERROR: Failed to load font!" << std::endl;
     }
 
-    sf::RenderWindow window(sf::VideoMode(MAP_WIDTH, MAP_HEIGHT), "2D Game - Save Selection");
-    window.setFramerateLimit(60);
-
-    // ϵͳ
-    ParticleSystem particleSystem(300);
-    sf::Clock particleClock;
+    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "2D Game - Save Selection");
+    // 绘制跟随显示器刷新率，逻辑帧在模拟线程按固定步长执行
+    window.setVerticalSyncEnabled(true);
 
-    // ʼһЩ
+    // 图片资源在工作线程解码，主线程每帧上传一部分，先显示存档选择界面。
+    // 每个文件只加载一次，角色图片 (选择界面和游戏中) 打包进同一张贴图集
+    ResourceCache resources;
+    SpriteHandle meleeIcon = resources.addSprite("meleeIcon", "resources/player/l1.png");
+    SpriteHandle rangedIcon = resources.addSprite("rangedIcon", "resources/player/tales.png");
+    SpriteHandle meleePlayerImage = resources.addSprite("meleePlayer", "resources/player/l11.png");
+    SpriteHandle rangedPlayerImage = resources.addSprite("rangedPlayer", "resources/player/tales1.png");
+    const char* bgFiles[4] = { "1.png", "2.png", "3.png", "4.png" };
+    for (int i = 0; i < 4; ++i) {
+        resources.requestTexture(bgFiles[i]);
+    }
+    resources.requestTexture("resources/player/victory.png");
+    resources.requestTexture("resources/player/lose.png");
+    resources.startLoading();
+    bool resourcesReady = false;
+    bool firstFrameShown = false;
+    bool showProfiler = false;   // F3 打开帧耗时统计
+
+    // 创建粒子系统
+    ParticlePool menuParticles(300);
+    menuParticles.setWrapArea(sf::FloatRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT));
+    Rng menuRng(makeRunSeed());   // 背景粒子只是装饰，使用自己的随机数流
+    ShapeBatch menuBatch;
+    float menuTime = 0.f;         // 背景粒子也按逻辑帧的步长更新，速度与刷新率无关
+    sf::Clock frameClock;
+
+    // 初始化一些粒子
     for (int i = 0; i < 100; ++i) {
-        float x = static_cast<float>(rand() % MAP_WIDTH);
-        float y = static_cast<float>(rand() % MAP_HEIGHT);
-        particleSystem.addParticle(sf::Vector2f(x, y));
+        addRandomMenuParticle(menuParticles, menuRng);
     }
 
-    // UIԪ
+    // UI元素
     sf::Text healthText;
     healthText.setFont(font);
     healthText.setCharacterSize(24);
@@ -1022,415 +238,428 @@ int main() {
     gameOverText.setCharacterSize(48);
     gameOverText.setFillColor(sf::Color::Red);
     gameOverText.setString("Game Over!");
-    gameOverText.setPosition(MAP_WIDTH / 2 - gameOverText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - 50);
+    gameOverText.setPosition(WINDOW_WIDTH / 2 - gameOverText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - 50);
 
     sf::RectangleShape restartButton(sf::Vector2f(200, 50));
     restartButton.setFillColor(sf::Color::Green);
-    restartButton.setPosition(MAP_WIDTH / 2 - 250, MAP_HEIGHT / 2 + 100);
+    restartButton.setPosition(WINDOW_WIDTH / 2 - 250, WINDOW_HEIGHT / 2 + 100);
 
     sf::Text restartText;
     restartText.setFont(font);
     restartText.setCharacterSize(24);
     restartText.setFillColor(sf::Color::White);
     restartText.setString("Restart");
-    restartText.setPosition(MAP_WIDTH / 2 - 250 + 100 - restartText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 115);
+    restartText.setPosition(WINDOW_WIDTH / 2 - 250 + 100 - restartText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 115);
 
-    // ˳ť
+    // 退出按钮
     sf::RectangleShape quitButton(sf::Vector2f(200, 50));
     quitButton.setFillColor(sf::Color::Red);
-    quitButton.setPosition(MAP_WIDTH / 2 + 50, MAP_HEIGHT / 2 + 100);
+    quitButton.setPosition(WINDOW_WIDTH / 2 + 50, WINDOW_HEIGHT / 2 + 100);
 
     sf::Text quitText;
     quitText.setFont(font);
     quitText.setCharacterSize(24);
     quitText.setFillColor(sf::Color::White);
     quitText.setString("Quit");
-    quitText.setPosition(MAP_WIDTH / 2 + 50 + 100 - quitText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 115);
+    quitText.setPosition(WINDOW_WIDTH / 2 + 50 + 100 - quitText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 115);
 
-    // һUI
+    // 下一关相关UI
     sf::Text nextLevelText;
     nextLevelText.setFont(font);
     nextLevelText.setCharacterSize(48);
     nextLevelText.setFillColor(sf::Color::Green);
     nextLevelText.setString("Level Complete!");
-    nextLevelText.setPosition(MAP_WIDTH / 2 - nextLevelText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - 50);
+    nextLevelText.setPosition(WINDOW_WIDTH / 2 - nextLevelText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - 50);
 
     sf::RectangleShape nextLevelButton(sf::Vector2f(200, 50));
     nextLevelButton.setFillColor(sf::Color::Green);
-    nextLevelButton.setPosition(MAP_WIDTH / 2 - 100, MAP_HEIGHT / 2 + 20);
+    nextLevelButton.setPosition(WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2 + 20);
 
     sf::Text nextLevelConfirmText;
     nextLevelConfirmText.setFont(font);
     nextLevelConfirmText.setCharacterSize(24);
     nextLevelConfirmText.setFillColor(sf::Color::White);
     nextLevelConfirmText.setString("Continue");
-    nextLevelConfirmText.setPosition(MAP_WIDTH / 2 - nextLevelConfirmText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 35);
+    nextLevelConfirmText.setPosition(WINDOW_WIDTH / 2 - nextLevelConfirmText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 35);
 
-    // ʤUI
+    // 胜利相关UI
     sf::Text victoryText;
     victoryText.setFont(font);
     victoryText.setCharacterSize(48);
     victoryText.setFillColor(sf::Color::Red);
     victoryText.setString("Victory!");
-    victoryText.setPosition(MAP_WIDTH / 2 - victoryText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - 50);
+    victoryText.setPosition(WINDOW_WIDTH / 2 - victoryText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - 50);
 
     sf::RectangleShape victoryRestartButton(sf::Vector2f(200, 50));
     victoryRestartButton.setFillColor(sf::Color::Green);
-    victoryRestartButton.setPosition(MAP_WIDTH / 2 - 250, MAP_HEIGHT / 2 + 100);
+    victoryRestartButton.setPosition(WINDOW_WIDTH / 2 - 250, WINDOW_HEIGHT / 2 + 100);
 
     sf::Text victoryRestartText;
     victoryRestartText.setFont(font);
     victoryRestartText.setCharacterSize(24);
     victoryRestartText.setFillColor(sf::Color::White);
     victoryRestartText.setString("Restart");
-    victoryRestartText.setPosition(MAP_WIDTH / 2 - 250 + 100 - victoryRestartText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 115);
+    victoryRestartText.setPosition(WINDOW_WIDTH / 2 - 250 + 100 - victoryRestartText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 115);
 
-    // ͣ˵UI
+    // 暂停菜单UI
     sf::RectangleShape pauseButton(sf::Vector2f(40, 40));
     pauseButton.setFillColor(sf::Color(100, 100, 100, 200));
-    pauseButton.setPosition(MAP_WIDTH - 50, 10);
+    pauseButton.setPosition(WINDOW_WIDTH - 50, 10);
 
     sf::RectangleShape pauseMenuBg(sf::Vector2f(300, 200));
     pauseMenuBg.setFillColor(sf::Color(50, 50, 50, 230));
-    pauseMenuBg.setPosition(MAP_WIDTH / 2 - 150, MAP_HEIGHT / 2 - 100);
+    pauseMenuBg.setPosition(WINDOW_WIDTH / 2 - 150, WINDOW_HEIGHT / 2 - 100);
 
     sf::Text pauseTitle;
     pauseTitle.setFont(font);
     pauseTitle.setCharacterSize(32);
     pauseTitle.setFillColor(sf::Color::White);
     pauseTitle.setString("Paused");
-    pauseTitle.setPosition(MAP_WIDTH / 2 - pauseTitle.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - 80);
+    pauseTitle.setPosition(WINDOW_WIDTH / 2 - pauseTitle.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - 80);
 
     sf::RectangleShape continueButton(sf::Vector2f(200, 50));
     continueButton.setFillColor(sf::Color::Green);
-    continueButton.setPosition(MAP_WIDTH / 2 - 100, MAP_HEIGHT / 2 - 30);
+    continueButton.setPosition(WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2 - 30);
 
     sf::Text continueText;
     continueText.setFont(font);
     continueText.setCharacterSize(24);
     continueText.setFillColor(sf::Color::White);
     continueText.setString("Continue");
-    continueText.setPosition(MAP_WIDTH / 2 - continueText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - 20);
+    continueText.setPosition(WINDOW_WIDTH / 2 - continueText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - 20);
 
     sf::RectangleShape exitButton(sf::Vector2f(200, 50));
     exitButton.setFillColor(sf::Color::Red);
-    exitButton.setPosition(MAP_WIDTH / 2 - 100, MAP_HEIGHT / 2 + 30);
+    exitButton.setPosition(WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2 + 30);
 
     sf::Text exitText;
     exitText.setFont(font);
     exitText.setCharacterSize(24);
     exitText.setFillColor(sf::Color::White);
     exitText.setString("Exit");
-    exitText.setPosition(MAP_WIDTH / 2 - exitText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 40);
+    exitText.setPosition(WINDOW_WIDTH / 2 - exitText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 40);
 
-    // ͣťͼ
+    // 暂停按钮图标
     sf::RectangleShape pauseIcon1(sf::Vector2f(5, 20));
     pauseIcon1.setFillColor(sf::Color::White);
 
     sf::RectangleShape pauseIcon2(sf::Vector2f(5, 20));
     pauseIcon2.setFillColor(sf::Color::White);
 
-    // 浵ѡԪ
+    // 存档选择界面元素
     sf::Text saveSelectTitle;
     saveSelectTitle.setFont(font);
     saveSelectTitle.setCharacterSize(48);
     saveSelectTitle.setFillColor(sf::Color::White);
     saveSelectTitle.setString("Select Save");
-    saveSelectTitle.setPosition(MAP_WIDTH / 2 - saveSelectTitle.getGlobalBounds().width / 2, 100);
+    saveSelectTitle.setPosition(WINDOW_WIDTH / 2 - saveSelectTitle.getGlobalBounds().width / 2, 100);
 
-    std::vector<sf::RectangleShape> saveSlots(3);
-    std::vector<sf::Text> saveTexts(3);
-    std::vector<sf::RectangleShape> deleteButtons(3);  // ɾť
-    std::vector<sf::Text> deleteTexts(3);  // ɾť
-    for (int i = 0; i < 3; i++) {
+    std::vector<sf::RectangleShape> saveSlots(SaveService::SLOT_COUNT);
+    std::vector<sf::Text> saveTexts(SaveService::SLOT_COUNT);
+    std::vector<sf::RectangleShape> deleteButtons(3);  // 删除按钮
+    std::vector<sf::Text> deleteTexts(3);  // 删除按钮文字
+    for (int i = 0; i < SaveService::SLOT_COUNT; i++) {
         saveSlots[i].setSize(sf::Vector2f(300, 80));
         saveSlots[i].setFillColor(sf::Color(100, 100, 100));
-        saveSlots[i].setPosition(MAP_WIDTH / 2 - 150, 200 + i * 120);
+        saveSlots[i].setPosition(WINDOW_WIDTH / 2 - 150, 200 + i * 120);
 
         saveTexts[i].setFont(font);
         saveTexts[i].setCharacterSize(24);
         saveTexts[i].setFillColor(sf::Color::White);
-        saveTexts[i].setPosition(MAP_WIDTH / 2 - 140, 220 + i * 120);
+        saveTexts[i].setPosition(WINDOW_WIDTH / 2 - 140, 220 + i * 120);
 
-        // ʼɾť
+        // 初始化删除按钮
         deleteButtons[i].setSize(sf::Vector2f(60, 30));
         deleteButtons[i].setFillColor(sf::Color::Red);
-        deleteButtons[i].setPosition(MAP_WIDTH / 2 + 160, 225 + i * 120);  // ڴ浵λҲ
+        deleteButtons[i].setPosition(WINDOW_WIDTH / 2 + 160, 225 + i * 120);  // 放在存档槽位右侧
 
         deleteTexts[i].setFont(font);
         deleteTexts[i].setCharacterSize(16);
         deleteTexts[i].setFillColor(sf::Color::White);
         deleteTexts[i].setString("Delete");
-        deleteTexts[i].setPosition(MAP_WIDTH / 2 + 165, 230 + i * 120);
+        deleteTexts[i].setPosition(WINDOW_WIDTH / 2 + 165, 230 + i * 120);
     }
 
-    // 浵ť
+    // 存档按钮
     sf::RectangleShape saveButton(sf::Vector2f(200, 50));
     saveButton.setFillColor(sf::Color::White);
-    saveButton.setPosition(MAP_WIDTH / 2 - 100, MAP_HEIGHT / 2 + 90);  // λõContinueExitť·
+    saveButton.setPosition(WINDOW_WIDTH / 2 - 100, WINDOW_HEIGHT / 2 + 90);  // 调整位置到Continue和Exit按钮下方
 
     sf::Text saveButtonText;
     saveButtonText.setFont(font);
     saveButtonText.setCharacterSize(24);
     saveButtonText.setFillColor(sf::Color::Black);
     saveButtonText.setString("Save");
-    saveButtonText.setPosition(MAP_WIDTH / 2 - saveButtonText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 100);
+    saveButtonText.setPosition(WINDOW_WIDTH / 2 - saveButtonText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 100);
+
+    // 加载进度 (存档选择界面底部)
+    sf::Text loadingText;
+    loadingText.setFont(font);
+    loadingText.setCharacterSize(18);
+    loadingText.setFillColor(sf::Color(180, 180, 220));
 
-    // ɫѡԪ
-    std::vector<sf::Texture> bgTextures(4);
+    // 角色选择界面元素 (贴图加载完后才设置)
     std::vector<sf::Sprite> bgSprites(4);
     bool bgLoaded[4] = { false, false, false, false };
-    const char* bgFiles[4] = { "1.png", "2.png", "3.png", "4.png" };
-    for (int i = 0; i < 4; ++i) {
-        if (bgTextures[i].loadFromFile(bgFiles[i])) {
-            bgSprites[i].setTexture(bgTextures[i]);
-            bgLoaded[i] = true;
-        }
-    }
     int bgIndex = 0;
     sf::Clock bgClock;
 
-    // սɫѡ
-    sf::Texture meleeTexture;
+    // 近战角色选项
     sf::Sprite meleeSprite;
-    if (!meleeTexture.loadFromFile("resources/player/l1.png")) {
-        std::cerr << "Error: Failed to load melee character texture!" << std::endl;
-    }
-    meleeSprite.setTexture(meleeTexture, true);
-    meleeSprite.setPosition(MAP_WIDTH / 4 - meleeSprite.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - meleeSprite.getGlobalBounds().height / 2);
 
     sf::Text meleeText;
     meleeText.setFont(font);
     meleeText.setCharacterSize(24);
     meleeText.setFillColor(sf::Color::White);
     meleeText.setString("Melee Player");
-    meleeText.setPosition(MAP_WIDTH / 4 - meleeText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 120);
+    meleeText.setPosition(WINDOW_WIDTH / 4 - meleeText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 120);
 
     sf::Text meleeDesc;
     meleeDesc.setFont(font);
     meleeDesc.setCharacterSize(18);
     meleeDesc.setFillColor(sf::Color::White);
     meleeDesc.setString("Fast Speed");
-    meleeDesc.setPosition(MAP_WIDTH / 4 - meleeDesc.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 160);
+    meleeDesc.setPosition(WINDOW_WIDTH / 4 - meleeDesc.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 160);
 
-    // Զ̽ɫѡ
-    sf::Texture rangedTexture;
+    // 远程角色选项
     sf::Sprite rangedSprite;
-    if (!rangedTexture.loadFromFile("resources/player/tales.png")) {
-        std::cerr << "Error: Failed to load ranged character texture!" << std::endl;
-    }
-    rangedSprite.setTexture(rangedTexture, true);
-    rangedSprite.setPosition(3 * MAP_WIDTH / 4 - rangedSprite.getGlobalBounds().width / 2, MAP_HEIGHT / 2 - rangedSprite.getGlobalBounds().height / 2);
 
     sf::Text rangedText;
     rangedText.setFont(font);
     rangedText.setCharacterSize(24);
     rangedText.setFillColor(sf::Color::White);
     rangedText.setString("Ranged Player");
-    rangedText.setPosition(3 * MAP_WIDTH / 4 - rangedText.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 120);
+    rangedText.setPosition(3 * WINDOW_WIDTH / 4 - rangedText.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 120);
 
     sf::Text rangedDesc;
     rangedDesc.setFont(font);
     rangedDesc.setCharacterSize(18);
     rangedDesc.setFillColor(sf::Color::White);
     rangedDesc.setString("Long Range");
-    rangedDesc.setPosition(3 * MAP_WIDTH / 4 - rangedDesc.getGlobalBounds().width / 2, MAP_HEIGHT / 2 + 160);
+    rangedDesc.setPosition(3 * WINDOW_WIDTH / 4 - rangedDesc.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 + 160);
 
-    // ʤ汳ͼƬ
-    sf::Texture victoryBgTexture;
+    // 添加胜利界面背景图片
     sf::Sprite victoryBgSprite;
-    if (!victoryBgTexture.loadFromFile("resources/player/victory.png")) {
-        std::cerr << "Error: Failed to load victory background texture!" << std::endl;
-    }
-    else {
-        victoryBgSprite.setTexture(victoryBgTexture);
-        // ͼƬСӦ
-        float scaleX = static_cast<float>(MAP_WIDTH) / victoryBgTexture.getSize().x;
-        float scaleY = static_cast<float>(MAP_HEIGHT) / victoryBgTexture.getSize().y;
-        victoryBgSprite.setScale(scaleX, scaleY);
-    }
 
-    // ʧܽ汳ͼƬ
-    sf::Texture loseBgTexture;
+    // 添加失败界面背景图片
     sf::Sprite loseBgSprite;
-    if (!loseBgTexture.loadFromFile("resources/player/lose.png")) {
-        std::cerr << "Error: Failed to load lose background texture!" << std::endl;
-    }
-    else {
-        loseBgSprite.setTexture(loseBgTexture);
-        // ͼƬСӦ
-        float scaleX = static_cast<float>(MAP_WIDTH) / loseBgTexture.getSize().x;
-        float scaleY = static_cast<float>(MAP_HEIGHT) / loseBgTexture.getSize().y;
-        loseBgSprite.setScale(scaleX, scaleY);
-    }
 
-    // ɫѡ
+    // 贴图全部上传后设置各个精灵 (精灵的大小和位置取决于贴图尺寸)
+    auto setupLoadedSprites = [&]() {
+        for (int i = 0; i < 4; ++i) {
+            const sf::Texture& bgTexture = resources.getTexture(bgFiles[i]);
+            if (bgTexture.getSize().x > 0) {
+                bgSprites[i].setTexture(bgTexture, true);
+                bgLoaded[i] = true;
+            }
+        }
+
+        resources.applySprite(meleeSprite, meleeIcon);
+        meleeSprite.setPosition(WINDOW_WIDTH / 4 - meleeSprite.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - meleeSprite.getGlobalBounds().height / 2);
+        resources.applySprite(rangedSprite, rangedIcon);
+        rangedSprite.setPosition(3 * WINDOW_WIDTH / 4 - rangedSprite.getGlobalBounds().width / 2, WINDOW_HEIGHT / 2 - rangedSprite.getGlobalBounds().height / 2);
+
+        const sf::Texture& victoryBgTexture = resources.getTexture("resources/player/victory.png");
+        if (victoryBgTexture.getSize().x > 0) {
+            victoryBgSprite.setTexture(victoryBgTexture, true);
+            // 调整背景图片大小以适应窗口
+            float scaleX = static_cast<float>(WINDOW_WIDTH) / victoryBgTexture.getSize().x;
+            float scaleY = static_cast<float>(WINDOW_HEIGHT) / victoryBgTexture.getSize().y;
+            victoryBgSprite.setScale(scaleX, scaleY);
+        }
+
+        const sf::Texture& loseBgTexture = resources.getTexture("resources/player/lose.png");
+        if (loseBgTexture.getSize().x > 0) {
+            loseBgSprite.setTexture(loseBgTexture, true);
+            // 调整背景图片大小以适应窗口
+            float scaleX = static_cast<float>(WINDOW_WIDTH) / loseBgTexture.getSize().x;
+            float scaleY = static_cast<float>(WINDOW_HEIGHT) / loseBgTexture.getSize().y;
+            loseBgSprite.setScale(scaleX, scaleY);
+        }
+    };
+
+    // 角色选择界面标题
     sf::Text characterSelectTitle;
     characterSelectTitle.setFont(font);
     characterSelectTitle.setCharacterSize(48);
     characterSelectTitle.setFillColor(sf::Color::White);
     characterSelectTitle.setString("Select your character!");
-    characterSelectTitle.setPosition(MAP_WIDTH / 2 - characterSelectTitle.getGlobalBounds().width / 2, 100);
-
-    // Ϸ״̬
-    bool inSaveSelection = true;  // Ƿڴ浵ѡ
-    std::vector<GameSave> saves = loadSaves();
-    int currentSaveSlot = -1;    // ǰʹõĴ浵λ
-
-    // Ϸ
-    Player* player = nullptr;
-    std::vector<BlueMeleeMonster> blueMonsters;
-    std::vector<RedMeleeMonster> redMonsters;
-    std::vector<YellowMeleeMonster> yellowMonsters;
-    std::vector<RangedMonster> rangedMonsters;
-    std::vector<Bullet> bullets;
-    std::vector<DeathEffect> deathEffects;
-    std::vector<TeleportEffect> teleportEffects;  // ӴЧ
-    int score = 0;
-    int currentLevel = 1;
-    std::vector<Obstacle> obstacles;
-
-    // Ϸ״̬
-    bool gameOver = false;
-    bool nextLevelAvailable = false;
-    bool gameWon = false;
-    bool needCharacterSelection = true;  // ʼ״̬Ҫѡɫ
-    bool gamePaused = false;  // ͣ״̬
-
-    // Ϸʼʱɵһصϰ
-    obstacles = generateObstacles(currentLevel);
-
-    // Ϸѭ
+    characterSelectTitle.setPosition(WINDOW_WIDTH / 2 - characterSelectTitle.getGlobalBounds().width / 2, 100);
+
+    // 玩家贴图 (只在绘制时按逻辑位置摆放)
+    sf::Sprite playerSprite;
+
+    // 游戏画面分三层绘制：玩家贴图下面的障碍物 (快照里的批次)，上面的怪物和子弹 (插值后)，最上面的特效
+    ShapeBatch entityBatch;
+
+    // 游戏画面用跟随玩家的摄像机，只画视野内的东西；界面仍按窗口坐标绘制
+    sf::View camera(sf::FloatRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT));
+
+    // 游戏状态
+    bool inSaveSelection = true;  // 是否在存档选择界面
+    SaveService saveService;     // 后台读写存档，存档选择界面读它的摘要缓存
+    int currentSaveSlot = -1;    // 当前使用的存档槽位
+    int loadingSlot = -1;        // 正在后台读取的存档槽位
+    unsigned long long lastAutosaveTick = 0;
+
+    // 游戏世界 (所有游戏逻辑)，在模拟线程推进
+    World world;
+
+    bool needCharacterSelection = true;  // 初始状态需要选择角色
+    bool gamePaused = false;  // 添加暂停状态变量
+
+    // 录像：正常游戏时记录每个逻辑帧的输入；main --watch <录像文件> 按实际速度播放录像
+    ReplayRecorder recorder;
+    Replay finishedReplay;       // 一局结束时从录像器取出，在主线程不持有世界锁时写入文件
+    Replay watchedReplay;
+    ReplayPlayer replayPlayer;
+    bool watchingReplay = false;
+    if (argc >= 3 && std::string(argv[1]) == "--watch") {
+        if (loadReplay(watchedReplay, argv[2])) {
+            replayPlayer.start(watchedReplay, world);
+            watchingReplay = true;
+            inSaveSelection = false;
+            needCharacterSelection = false;
+        }
+        else {
+            std::cerr << "Error: Failed to load replay " << argv[2] << std::endl;
+        }
+    }
+
+    // 模拟线程每个逻辑帧执行的内容 (持有世界锁，上面这些状态在主线程也只在持有世界锁时访问)
+    SimThread sim(world, [&](const InputFrame& input) {
+        if (watchingReplay && world.getStatus() == WorldStatus::LEVEL_COMPLETE && !replayPlayer.isFinished()) {
+            world.nextLevel();  // 录像中的关卡结束后直接进入下一关
+        }
+        if (!world.isRunning()) {
+            return;
+        }
+        if (watchingReplay) {
+            replayPlayer.step(world);
+        }
+        else {
+            world.step(input);
+            recorder.record(input, world);
+        }
+
+        // 自动存档 (在后台只追加变化的块)
+        if (!watchingReplay && currentSaveSlot >= 0 && world.isRunning() &&
+            world.getTick() - lastAutosaveTick >= AUTOSAVE_TICKS) {
+            saveGame(world, saveService, currentSaveSlot, true);
+            lastAutosaveTick = world.getTick();
+        }
+    });
+
+    // 游戏主循环 (处理输入和绘制)
     while (window.isOpen()) {
+        // 上传后台解码好的贴图，全部完成后设置精灵
+        if (!resourcesReady) {
+            resources.uploadPending(TEXTURE_UPLOAD_BUDGET);
+            if (resources.isLoaded()) {
+                setupLoadedSprites();
+                resourcesReady = true;
+                std::cout << "resources loaded: " << startupClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+            }
+        }
+
+        // 处理输入和存档回调时锁住世界，模拟线程在两个逻辑帧之间等待
+        std::unique_lock<std::mutex> worldLock(sim.getWorldMutex());
         sf::Event event;
         while (window.pollEvent(event)) {
+            PROFILE_ZONE("events");
             if (event.type == sf::Event::Closed)
                 window.close();
 
+            if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::F3) {
+                    showProfiler = !showProfiler;
+                    Profiler::instance().setEnabled(showProfiler);
+                }
+                else if (event.key.code == sf::Keyboard::F4 && Profiler::instance().isEnabled()) {
+                    if (Profiler::instance().exportChromeTrace(TRACE_FILE)) {
+                        std::cout << "trace written to " << TRACE_FILE << std::endl;
+                    }
+                    else {
+                        std::cerr << "Error: Failed to write " << TRACE_FILE << std::endl;
+                    }
+                }
+            }
+
             if (event.type == sf::Event::MouseButtonPressed) {
                 sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
 
                 if (inSaveSelection) {
-                    // 浵ѡĵ
-                    for (int i = 0; i < 3; i++) {
-                        if (saves[i].exists && deleteButtons[i].getGlobalBounds().contains(mousePos)) {
-                            // ɾ浵
-                            deleteSave(i);
-                            // ¼д浵
-                            saves = loadSaves();
-                            continue;  // 浵λĵ
-                        }
-                        if (saveSlots[i].getGlobalBounds().contains(mousePos)) {
-                            currentSaveSlot = i;
-                            if (saves[i].exists) {
-                                // д浵
-                                currentLevel = saves[i].currentLevel;
-                                score = saves[i].score;
-                                if (saves[i].playerType == 0) {
-                                    player = new MeleePlayer();
+                    // 存档服务还有请求没完成时摘要可能过时 (启动时还没扫描完，或刚保存的存档还没写完)，
+                    // 这时点空槽位会覆盖已有存档，等请求全部完成再响应点击
+                    if (loadingSlot < 0 && !saveService.isBusy()) {
+                        // 处理存档选择界面的点击
+                        for (int i = 0; i < SaveService::SLOT_COUNT; i++) {
+                            SaveSummary slot = saveService.getSlot(i);
+                            if (slot.exists && deleteButtons[i].getGlobalBounds().contains(mousePos)) {
+                                // 删除存档 (摘要缓存由存档服务更新)
+                                saveService.remove(i);
+                                continue;  // 跳过存档槽位的点击检测
+                            }
+                            // 贴图加载完之前不能离开存档选择界面
+                            if (resourcesReady && saveSlots[i].getGlobalBounds().contains(mousePos)) {
+                                currentSaveSlot = i;
+                                if (slot.exists) {
+                                    // 加载已有存档：后台读取，读完后在游戏线程恢复世界
+                                    loadingSlot = i;
+                                    saveService.load(i, [&](bool ok, const WorldSnapshot& snapshot, const SaveSummary& summary) {
+                                        loadingSlot = -1;
+                                        inSaveSelection = false;
+                                        if (ok && restoreGame(world, snapshot, summary)) {
+                                            // 快照恢复的局面无法由种子重新生成，只有从关卡开头开始的局才录像
+                                            if (world.getTick() == 0) {
+                                                recorder.begin(world);
+                                            }
+                                            lastAutosaveTick = world.getTick();
+                                            needCharacterSelection = false;
+                                        }
+                                        else {
+                                            // 存档读取失败，当作空存档重新选择角色
+                                            std::cerr << "Error: Failed to load save " << currentSaveSlot + 1 << std::endl;
+                                            needCharacterSelection = true;
+                                        }
+                                    });
                                 }
                                 else {
-                                    player = new RangedPlayer();
-                                }
-                                player->setHealth(saves[i].health);
-                                inSaveSelection = false;
-                                needCharacterSelection = false;
-                                obstacles = generateObstacles(currentLevel);
-
-                                // ʼ
-                                int baseCount = currentLevel + 1;
-                                for (int i = 0; i < baseCount; ++i) {
-                                    blueMonsters.emplace_back(obstacles);
-                                }
-                                for (int i = 0; i < baseCount; ++i) {
-                                    redMonsters.emplace_back(obstacles);
+                                    // 空存档，进入角色选择界面
+                                    inSaveSelection = false;
+                                    needCharacterSelection = true;
                                 }
-                                for (int i = 0; i < baseCount; ++i) {
-                                    yellowMonsters.emplace_back(obstacles);
-                                }
-                                for (int i = 0; i < baseCount; ++i) {
-                                    rangedMonsters.emplace_back(obstacles);
-                                }
-                            }
-                            else {
-                                // մ浵ɫѡ
-                                inSaveSelection = false;
-                                needCharacterSelection = true;
-                                currentLevel = 1;
-                                score = 0;
-                                obstacles = generateObstacles(currentLevel);
-                                // ڴ´浵¼ش浵
-                                saves = loadSaves();
                             }
                         }
                     }
                 }
                 else if (needCharacterSelection) {
-                    // ɫѡĵ
+                    // 处理角色选择界面的点击
+                    int playerType = -1;
                     if (meleeSprite.getGlobalBounds().contains(mousePos)) {
-                        player = new MeleePlayer();
-                        needCharacterSelection = false;
-                        // ʼһصĹ
-                        for (int i = 0; i < 2; ++i) {
-                            blueMonsters.emplace_back(obstacles);
-                        }
-                        for (int i = 0; i < 2; ++i) {
-                            redMonsters.emplace_back(obstacles);
-                        }
-                        for (int i = 0; i < 2; ++i) {
-                            yellowMonsters.emplace_back(obstacles);
-                        }
-                        for (int i = 0; i < 2; ++i) {
-                            rangedMonsters.emplace_back(obstacles);
-                        }
-                        // ´浵
-                        GameSave save;
-                        save.playerType = 0;  // ս
-                        save.health = player->getHealth();
-                        save.currentLevel = currentLevel;
-                        save.score = score;
-                        save.exists = true;
-                        saveGame(save, currentSaveSlot);
+                        playerType = 0;  // 近战
                     }
                     else if (rangedSprite.getGlobalBounds().contains(mousePos)) {
-                        player = new RangedPlayer();
+                        playerType = 1;  // 远程
+                    }
+                    if (playerType >= 0) {
+                        // 从第一关开始
+                        world.start(playerType, 1, 0, PLAYER_MAX_HEALTH, makeRunSeed());
+                        recorder.begin(world);
                         needCharacterSelection = false;
-                        // ʼһصĹ
-                        for (int i = 0; i < 2; ++i) {
-                            blueMonsters.emplace_back(obstacles);
-                        }
-                        for (int i = 0; i < 2; ++i) {
-                            redMonsters.emplace_back(obstacles);
-                        }
-                        for (int i = 0; i < 2; ++i) {
-                            yellowMonsters.emplace_back(obstacles);
-                        }
-                        for (int i = 0; i < 2; ++i) {
-                            rangedMonsters.emplace_back(obstacles);
-                        }
-                        // ´浵
-                        GameSave save;
-                        save.playerType = 1;  // Զ
-                        save.health = player->getHealth();
-                        save.currentLevel = currentLevel;
-                        save.score = score;
-                        save.exists = true;
-                        saveGame(save, currentSaveSlot);
+                        // 创建新存档
+                        saveGame(world, saveService, currentSaveSlot, false);
+                        lastAutosaveTick = world.getTick();
                     }
                 }
-                else if (!gameOver && !nextLevelAvailable && !gameWon && !gamePaused) {
-                    // Ϸеĵ
+                else if (world.isRunning() && !gamePaused) {
+                    // 游戏进行中的点击处理：攻击留到下一个逻辑帧执行
                     if (pauseButton.getGlobalBounds().contains(mousePos)) {
                         gamePaused = true;
                     }
-                    else if (dynamic_cast<MeleePlayer*>(player) && player->canShoot()) {
-                        static_cast<MeleePlayer*>(player)->startSweep();
-                        player->setShootCooldown();
-                    }
-                    else if (player->canShoot()) {
-                        sf::Vector2f playerCenter = player->getShape().getPosition() + sf::Vector2f(player->getShape().getSize().x / 2, player->getShape().getSize().y / 2);
-                        bullets.emplace_back(playerCenter, mousePos, true);
-                        player->setShootCooldown();
+                    else if (!watchingReplay) {
+                        // 点击位置换算成地图坐标
+                        sim.queueAttack(window.mapPixelToCoords(sf::Mouse::getPosition(window), camera));
                     }
                 }
                 else if (gamePaused) {
@@ -1439,61 +668,34 @@ int main() {
                     }
                     else if (saveButton.getGlobalBounds().contains(mousePos)) {
                         if (currentSaveSlot >= 0) {
-                            // Ϸ״̬
-                            GameSave save;
-                            save.playerType = dynamic_cast<MeleePlayer*>(player) ? 0 : 1;
-                            save.health = player->getHealth();
-                            save.currentLevel = currentLevel;
-                            save.score = score;
-                            save.exists = true;
-                            saveGame(save, currentSaveSlot);
-
-                            // ¼д浵
-                            saves = loadSaves();
-
-                            // ش浵ѡ
+                            // 保存游戏状态 (存档选择界面的摘要由存档服务写完后更新)
+                            saveGame(world, saveService, currentSaveSlot, false);
+                            recorder.finish(REPLAY_FILE);
+
+                            // 返回存档选择界面
                             inSaveSelection = true;
                             gamePaused = false;
                         }
                     }
                     else if (exitButton.getGlobalBounds().contains(mousePos)) {
-                        // ش浵ѡ
-                        delete player;
-                        player = nullptr;
-                        blueMonsters.clear();
-                        redMonsters.clear();
-                        yellowMonsters.clear();
-                        rangedMonsters.clear();
-                        bullets.clear();
-                        deathEffects.clear();
-                        teleportEffects.clear();
-                        score = 0;
-                        currentLevel = 1;
-                        obstacles = generateObstacles(currentLevel);
-                        gameOver = false;
-                        nextLevelAvailable = false;
-                        gameWon = false;
+                        // 返回存档选择界面
+                        recorder.finish(REPLAY_FILE);
+                        world.reset();
+                        watchingReplay = false;
                         needCharacterSelection = true;
                         gamePaused = false;
                         inSaveSelection = true;
                     }
                 }
-                else if (nextLevelAvailable && nextLevelButton.getGlobalBounds().contains(mousePos)) {
-                    nextLevel(player, blueMonsters, redMonsters, yellowMonsters, rangedMonsters, score, currentLevel, obstacles);
-                    bullets.clear();
-                    deathEffects.clear();
-                    teleportEffects.clear();
-                    nextLevelAvailable = false;
+                else if (world.getStatus() == WorldStatus::LEVEL_COMPLETE && nextLevelButton.getGlobalBounds().contains(mousePos)) {
+                    world.nextLevel();
                 }
-                else if (gameWon || gameOver) {
-                    if ((gameOver && restartButton.getGlobalBounds().contains(mousePos)) ||
+                else if (world.getStatus() == WorldStatus::VICTORY || world.getStatus() == WorldStatus::GAME_OVER) {
+                    bool gameWon = world.getStatus() == WorldStatus::VICTORY;
+                    if ((!gameWon && restartButton.getGlobalBounds().contains(mousePos)) ||
                         (gameWon && victoryRestartButton.getGlobalBounds().contains(mousePos))) {
-                        restartGame(player, blueMonsters, redMonsters, yellowMonsters, rangedMonsters, score, currentLevel, obstacles);
-                        bullets.clear();
-                        deathEffects.clear();
-                        teleportEffects.clear();
-                        gameOver = false;
-                        gameWon = false;
+                        world.reset();
+                        watchingReplay = false;
                         needCharacterSelection = true;
                         inSaveSelection = true;
                     }
@@ -1504,25 +706,65 @@ int main() {
             }
         }
 
+        // 执行后台存档请求的完成回调 (读档完成后在这里恢复世界)
+        {
+            PROFILE_ZONE("save callbacks");
+            saveService.pollCompleted();
+        }
+
+        sim.setMovement(sf::Keyboard::isKeyPressed(sf::Keyboard::A), sf::Keyboard::isKeyPressed(sf::Keyboard::D),
+            sf::Keyboard::isKeyPressed(sf::Keyboard::W), sf::Keyboard::isKeyPressed(sf::Keyboard::S));
+        sim.setActive(!gamePaused && !needCharacterSelection && !inSaveSelection);
+        const WorldStatus status = world.getStatus();
+        // 一局结束：在锁里取出录像，解锁后再写文件，模拟线程不会等待磁盘
+        const bool replayEnded = (status == WorldStatus::VICTORY || status == WorldStatus::GAME_OVER) &&
+            recorder.take(finishedReplay);
+        worldLock.unlock();
+
+        if (replayEnded && !saveReplay(finishedReplay, REPLAY_FILE)) {
+            std::cerr << "Error: Failed to write replay " << REPLAY_FILE << std::endl;
+        }
+
+        // 游戏画面只读模拟线程发布的快照，按距离上一个逻辑帧的时间插值
+        const RenderSnapshot& snapshot = sim.acquireSnapshot();
+        const float alpha = snapshot.getInterpolation(RenderSnapshot::Clock::now());
+        const float maxMenuSeconds = SimThread::MAX_CATCH_UP_TICKS * World::TICK_SECONDS;
+        float frameSeconds = std::min(frameClock.restart().asSeconds(), maxMenuSeconds);
+
+        ProfileZone drawZone("draw");
         window.clear(sf::Color::Black);
 
         if (inSaveSelection) {
-            // ϵͳ
-            particleSystem.update(particleClock.restart().asSeconds());
+            // 更新粒子系统，持续添加新粒子
+            menuTime += frameSeconds;
+            while (menuTime >= World::TICK_SECONDS) {
+                menuParticles.updateSerial();   // 渲染线程不能向任务系统提交任务
+                if (menuRng.nextInt(5) == 0) {
+                    addRandomMenuParticle(menuParticles, menuRng);
+                }
+                menuTime -= World::TICK_SECONDS;
+            }
 
-            // Ⱦӱ
-            window.clear(sf::Color(10, 10, 40)); // ɫ
-            particleSystem.draw(window);
+            // 渲染粒子背景
+            window.clear(sf::Color(10, 10, 40)); // 深蓝色背景
+            menuBatch.clear();
+            menuParticles.appendTo(menuBatch);
+            menuBatch.draw(window);
 
-            // Ⱦ浵ѡ
+            // 渲染存档选择界面
             window.draw(saveSelectTitle);
-            for (int i = 0; i < 3; i++) {
+            const bool slotsReady = !saveService.isBusy();
+            for (int i = 0; i < SaveService::SLOT_COUNT; i++) {
                 window.draw(saveSlots[i]);
-                if (saves[i].exists) {
+                if (!slotsReady) {
+                    // 存档服务还在读写，摘要可能过时
+                    saveTexts[i].setString("Loading...");
+                }
+                else if (saveService.getSlot(i).exists) {
                     std::stringstream ss;
                     ss << "Save " << i + 1;
                     saveTexts[i].setString(ss.str());
-                    // ֻΪд浵ʾɾť
+                    // 只为已有存档显示删除按钮
                     window.draw(deleteButtons[i]);
                     window.draw(deleteTexts[i]);
                 }
@@ -1531,16 +773,22 @@ int main() {
                 }
                 window.draw(saveTexts[i]);
             }
+
+            if (!resourcesReady) {
+                loadingText.setString("Loading " + std::to_string(static_cast<int>(resources.getProgress() * 100)) + "%");
+                loadingText.setPosition(WINDOW_WIDTH / 2 - loadingText.getGlobalBounds().width / 2, WINDOW_HEIGHT - 60);
+                window.draw(loadingText);
+            }
         }
         else if (needCharacterSelection) {
-            // Ⱦɫѡ
+            // 渲染角色选择界面
             if (bgClock.getElapsedTime().asSeconds() > 1.5f) {
                 bgIndex = (bgIndex + 1) % 4;
                 bgClock.restart();
             }
             if (bgLoaded[bgIndex]) window.draw(bgSprites[bgIndex]);
 
-            // ӱ
+            // 添加标题
             window.draw(characterSelectTitle);
 
             window.draw(meleeSprite);
@@ -1550,42 +798,27 @@ int main() {
             window.draw(rangedText);
             window.draw(rangedDesc);
         }
-        else if (!gameOver && !nextLevelAvailable && !gameWon) {
-            // ȾϷ
-            for (const auto& obstacle : obstacles) {
-                window.draw(obstacle.getShape());
-            }
-
-            window.draw(player->getSprite());
-
-            if (MeleePlayer* meleePlayer = dynamic_cast<MeleePlayer*>(player)) {
-                meleePlayer->drawSweepEffect(window);
-            }
+        else if (status == WorldStatus::RUNNING) {
+            // 渲染游戏界面
+            camera.setCenter(cameraCenter(snapshot.getPlayerCenter(alpha)));
+            window.setView(camera);
 
-            for (const auto& blueMonster : blueMonsters) {
-                window.draw(blueMonster.getShape());
-            }
-            for (const auto& redMonster : redMonsters) {
-                window.draw(redMonster.getShape());
-            }
-            for (const auto& yellowMonster : yellowMonsters) {
-                window.draw(yellowMonster.getShape());
-            }
-            for (const auto& rangedMonster : rangedMonsters) {
-                window.draw(rangedMonster.getShape());
-            }
+            snapshot.background.draw(window);
 
-            for (const auto& bullet : bullets) {
-                window.draw(bullet.getShape());
-            }
+            resources.applySprite(playerSprite, snapshot.playerType == 0 ? meleePlayerImage : rangedPlayerImage);
+            playerSprite.setPosition(snapshot.getPlayerPosition(alpha));
+            window.draw(playerSprite);
 
-            for (const auto& effect : deathEffects) {
-                effect.draw(window);
-            }
+            entityBatch.clear();
+            snapshot.appendEntities(entityBatch, alpha);
+            entityBatch.draw(window);
+            snapshot.effects.draw(window);
+            window.setView(window.getDefaultView());
 
-            for (const auto& effect : teleportEffects) {
-                effect.draw(window);
-            }
+            // 更新UI文本
+            healthText.setString("Health: " + std::to_string(snapshot.health));
+            scoreText.setString("Score: " + std::to_string(snapshot.score));
+            levelText.setString("Level: " + std::to_string(snapshot.level) + "/" + std::to_string(MAX_LEVEL));
 
             window.draw(healthText);
             window.draw(scoreText);
@@ -1608,14 +841,14 @@ int main() {
                 window.draw(saveButtonText);
             }
         }
-        else if (nextLevelAvailable) {
+        else if (status == WorldStatus::LEVEL_COMPLETE) {
             window.draw(nextLevelText);
             window.draw(nextLevelButton);
             window.draw(nextLevelConfirmText);
         }
-        else if (gameWon || gameOver) {
-            if (gameWon) {
-                // Ȼʤ
+        else if (status == WorldStatus::VICTORY || status == WorldStatus::GAME_OVER) {
+            if (status == WorldStatus::VICTORY) {
+                // 先绘制胜利背景
                 window.draw(victoryBgSprite);
 
                 window.draw(victoryText);
@@ -1623,7 +856,7 @@ int main() {
                 window.draw(victoryRestartText);
             }
             else {
-                // Ȼʧܱ
+                // 先绘制失败背景
                 window.draw(loseBgSprite);
 
                 window.draw(restartButton);
@@ -1633,240 +866,24 @@ int main() {
             window.draw(quitText);
         }
 
-        window.display();
-
-        // Ϸ߼
-        if (!gameOver && !nextLevelAvailable && !gameWon && !gamePaused && !needCharacterSelection && !inSaveSelection) {
-            // ƶ
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::A))
-                player->move(-5, 0, obstacles);
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
-                player->move(5, 0, obstacles);
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::W))
-                player->move(0, -5, obstacles);
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::S))
-                player->move(0, 5, obstacles);
-
-            player->updateInvincibility();
-            player->updateShootCooldown();
-
-            // ɨ뷶Χ˺
-            if (dynamic_cast<MeleePlayer*>(player)) {
-                MeleePlayer* melee = static_cast<MeleePlayer*>(player);
-                melee->updateSweep();
-                static bool damageApplied = false;
-                if (melee->isSweeping()) {
-                    float sweepRadius = melee->getAttackRange();
-                    float sweepAngle = melee->getSweepAngle();
-                    sf::Vector2f center = melee->getShape().getPosition() + melee->getShape().getSize() / 2.f;
-                    if (!damageApplied && sweepAngle > 180.f) {
-                        auto inRange = [&](const sf::RectangleShape& m) {
-                            sf::Vector2f mCenter = m.getPosition() + m.getSize() / 2.f;
-                            float dist = std::hypot(center.x - mCenter.x, center.y - mCenter.y);
-                            return dist <= sweepRadius;
-                            };
-                        for (auto it = blueMonsters.begin(); it != blueMonsters.end();) {
-                            if (inRange(it->getShape())) {
-                                deathEffects.emplace_back(it->getShape().getPosition() + it->getShape().getSize() / 2.f, sf::Color::Blue);
-                                it = blueMonsters.erase(it);
-                                score++;
-                            }
-                            else { ++it; }
-                        }
-                        for (auto it = redMonsters.begin(); it != redMonsters.end();) {
-                            if (inRange(it->getShape())) {
-                                deathEffects.emplace_back(it->getShape().getPosition() + it->getShape().getSize() / 2.f, sf::Color::Red);
-                                it = redMonsters.erase(it);
-                                score++;
-                            }
-                            else { ++it; }
-                        }
-                        for (auto it = yellowMonsters.begin(); it != yellowMonsters.end();) {
-                            if (inRange(it->getShape())) {
-                                deathEffects.emplace_back(it->getShape().getPosition() + it->getShape().getSize() / 2.f, sf::Color::Yellow);
-                                it = yellowMonsters.erase(it);
-                                score++;
-                            }
-                            else { ++it; }
-                        }
-                        for (auto it = rangedMonsters.begin(); it != rangedMonsters.end();) {
-                            if (inRange(it->getShape())) {
-                                deathEffects.emplace_back(it->getShape().getPosition() + it->getShape().getSize() / 2.f, sf::Color::Magenta);
-                                it = rangedMonsters.erase(it);
-                                score++;
-                            }
-                            else { ++it; }
-                        }
-                        damageApplied = true;
-                    }
-                }
-                else {
-                    damageApplied = false;
-                }
-            }
+        drawZone.stop();
 
-            // Ч
-            for (auto effectIt = deathEffects.begin(); effectIt != deathEffects.end();) {
-                if (!effectIt->update()) {
-                    effectIt = deathEffects.erase(effectIt);
-                }
-                else {
-                    ++effectIt;
-                }
-            }
-
-            // ´Ч
-            for (auto effectIt = teleportEffects.begin(); effectIt != teleportEffects.end();) {
-                if (!effectIt->update()) {
-                    effectIt = teleportEffects.erase(effectIt);
-                }
-                else {
-                    ++effectIt;
-                }
-            }
-
-            // ƶ
-            sf::Vector2f playerPos = player->getShape().getPosition();
-            for (auto& blueMonster : blueMonsters) {
-                blueMonster.moveTowards(playerPos, teleportEffects, obstacles);
-            }
-            for (auto& redMonster : redMonsters) {
-                redMonster.moveTowards(playerPos, obstacles);
-            }
-            for (auto& yellowMonster : yellowMonsters) {
-                yellowMonster.moveTowards(playerPos, obstacles);
-            }
-            for (auto& rangedMonster : rangedMonsters) {
-                rangedMonster.moveTowards(playerPos, obstacles);
-                rangedMonster.shoot(playerPos, bullets);
-            }
-
-            // ӵƶײ
-            for (auto it = bullets.begin(); it != bullets.end();) {
-                bool bulletSurvived = it->move(obstacles);
-                bool bulletHit = false;
-
-                if (!bulletSurvived) {
-                    it = bullets.erase(it);
-                    continue;
-                }
-
-                // ӵй
-                if (it->isFromPlayer()) {
-                    // ɫ
-                    for (auto blueIt = blueMonsters.begin(); blueIt != blueMonsters.end();) {
-                        if (blueIt->isHit(it->getShape())) {
-                            deathEffects.emplace_back(blueIt->getShape().getPosition() + blueIt->getShape().getSize() / 2.f, sf::Color::Blue);
-                            blueIt = blueMonsters.erase(blueIt);
-                            bulletHit = true;
-                            score++;
-                            break;
-                        }
-                        else { ++blueIt; }
-                    }
-                    if (bulletHit) { it = bullets.erase(it); continue; }
-
-                    // ɫ
-                    for (auto redIt = redMonsters.begin(); redIt != redMonsters.end();) {
-                        if (redIt->isHit(it->getShape())) {
-                            deathEffects.emplace_back(redIt->getShape().getPosition() + redIt->getShape().getSize() / 2.f, sf::Color::Red);
-                            redIt = redMonsters.erase(redIt);
-                            bulletHit = true;
-                            score++;
-                            break;
-                        }
-                        else { ++redIt; }
-                    }
-                    if (bulletHit) { it = bullets.erase(it); continue; }
-
-                    // ɫ
-                    for (auto yellowIt = yellowMonsters.begin(); yellowIt != yellowMonsters.end();) {
-                        if (yellowIt->isHit(it->getShape())) {
-                            deathEffects.emplace_back(yellowIt->getShape().getPosition() + yellowIt->getShape().getSize() / 2.f, sf::Color::Yellow);
-                            yellowIt = yellowMonsters.erase(yellowIt);
-                            bulletHit = true;
-                            score++;
-                            break;
-                        }
-                        else { ++yellowIt; }
-                    }
-                    if (bulletHit) { it = bullets.erase(it); continue; }
-
-                    // Զ̹
-                    for (auto rangedIt = rangedMonsters.begin(); rangedIt != rangedMonsters.end();) {
-                        if (rangedIt->isHit(it->getShape())) {
-                            deathEffects.emplace_back(rangedIt->getShape().getPosition() + rangedIt->getShape().getSize() / 2.f, sf::Color::Magenta);
-                            rangedIt = rangedMonsters.erase(rangedIt);
-                            bulletHit = true;
-                            score++;
-                            break;
-                        }
-                        else { ++rangedIt; }
-                    }
-                    if (bulletHit) { it = bullets.erase(it); continue; }
-                }
-                // ӵ
-                else if (isCollision(player->getShape(), it->getShape())) {
-                    player->reduceHealth();
-                    bulletHit = true;
-                }
-
-                // ƳĿӵ
-                if (bulletHit ||
-                    it->getShape().getPosition().x < 0 ||
-                    it->getShape().getPosition().x > static_cast<float>(MAP_WIDTH) ||
-                    it->getShape().getPosition().y < 0 ||
-                    it->getShape().getPosition().y > static_cast<float>(MAP_HEIGHT)) {
-                    it = bullets.erase(it);
-                }
-                else {
-                    ++it;
-                }
-            }
-
-            // ײ
-            for (const auto& blueMonster : blueMonsters) {
-                if (isCollision(player->getShape(), blueMonster.getShape())) {
-                    player->reduceHealth();
-                }
-            }
-            for (const auto& redMonster : redMonsters) {
-                if (isCollision(player->getShape(), redMonster.getShape())) {
-                    player->reduceHealth();
-                }
-            }
-            for (const auto& yellowMonster : yellowMonsters) {
-                if (isCollision(player->getShape(), yellowMonster.getShape())) {
-                    player->reduceHealth();
-                }
-            }
-            for (const auto& rangedMonster : rangedMonsters) {
-                if (isCollision(player->getShape(), rangedMonster.getShape())) {
-                    player->reduceHealth();
-                }
-            }
-
-            // UIı
-            healthText.setString("Health: " + std::to_string(player->getHealth()));
-            scoreText.setString("Score: " + std::to_string(score));
-            levelText.setString("Level: " + std::to_string(currentLevel) + "/" + std::to_string(MAX_LEVEL));
+        if (showProfiler) {
+            drawProfilerOverlay(window, font);
+        }
 
-            // Ϸ״̬
-            if (player->getHealth() <= 0) {
-                gameOver = true;
-            }
-            else if (score >= 3) {  // ÿҪɱ3ֻ
-                score = 0;  // õǰؿķ
-                if (currentLevel >= MAX_LEVEL) {
-                    gameWon = true; // ɣϷʤ
-                }
-                else {
-                    nextLevelAvailable = true; // һ
-                }
-            }
+        {
+            PROFILE_ZONE("display");
+            window.display();
+        }
+        Profiler::instance().endFrame();
+        if (!firstFrameShown) {
+            firstFrameShown = true;
+            std::cout << "time to first frame: " << startupClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
         }
     }
 
-    delete player;
+    std::lock_guard<std::mutex> lock(sim.getWorldMutex());
+    recorder.finish(REPLAY_FILE);
     return 0;
-}
\ No newline at end of file
+}
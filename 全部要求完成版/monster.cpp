@@ -0,0 +1,415 @@
+#include "monster.h"
+#include "jobs.h"
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+const sf::Color monsterKindColors[MONSTER_KIND_COUNT] = {
+    sf::Color::Blue, sf::Color::Red, sf::Color::Yellow, sf::Color::Magenta
+};
+
+const float monsterKindSpeeds[MONSTER_KIND_COUNT] = { 1.0f, 1.0f, 1.0f, 0.8f };
+
+const unsigned char monsterKindAbilities[MONSTER_KIND_COUNT] = { ABILITY_TELEPORT, 0, 0, ABILITY_SHOOT };
+
+static int clampCell(int cell, int count) {
+    return cell < 0 ? 0 : (cell >= count ? count - 1 : cell);
+}
+
+// MonsterStore实现
+void MonsterStore::clear() {
+    x.clear();
+    y.clear();
+    w.clear();
+    h.clear();
+    kind.clear();
+    timer.clear();
+    cooldown.clear();
+    flags.clear();
+    goalX.clear();
+    goalY.clear();
+}
+
+void MonsterStore::add(MonsterKind monsterKind, const sf::Vector2f& position) {
+    x.push_back(position.x);
+    y.push_back(position.y);
+    w.push_back(30.f);
+    h.push_back(30.f);
+    kind.push_back(static_cast<unsigned char>(monsterKind));
+    timer.push_back(0);
+    cooldown.push_back(0);
+    flags.push_back(0);
+    goalX.push_back(position.x);
+    goalY.push_back(position.y);
+}
+
+bool MonsterStore::spawn(MonsterKind monsterKind, const SpawnSampler& spawns, Rng& rng) {
+    sf::Vector2f position;
+    if (!spawns.sample(rng, position)) {
+        return false;
+    }
+    add(monsterKind, position);
+    return true;
+}
+
+void MonsterStore::spawnWave(int countPerKind, const ObstacleGrid& obstacles, const sf::FloatRect& area, Rng& rng) {
+    SpawnSampler spawns;
+    spawns.build(obstacles, area, sf::Vector2f(30, 30));
+    for (int k = 0; k < MONSTER_KIND_COUNT; ++k) {
+        for (int i = 0; i < countPerKind; ++i) {
+            spawn(static_cast<MonsterKind>(k), spawns, rng);
+        }
+    }
+}
+
+void MonsterStore::removeSwap(size_t i) {
+    x[i] = x.back();
+    y[i] = y.back();
+    w[i] = w.back();
+    h[i] = h.back();
+    kind[i] = kind.back();
+    timer[i] = timer.back();
+    cooldown[i] = cooldown.back();
+    flags[i] = flags.back();
+    goalX[i] = goalX.back();
+    goalY[i] = goalY.back();
+    x.pop_back();
+    y.pop_back();
+    w.pop_back();
+    h.pop_back();
+    kind.pop_back();
+    timer.pop_back();
+    cooldown.pop_back();
+    flags.pop_back();
+    goalX.pop_back();
+    goalY.pop_back();
+}
+
+// 替代方向的探测顺序：依次旋转 45, -45, 90, -90, 135, -135, 180, 0 度 (cos, sin)。
+// 旋转不改变长度，单位方向旋转后仍是单位方向，不需要重新标准化
+struct ProbeRotation {
+    float c;
+    float s;
+};
+
+static constexpr float HALF_SQRT2 = 0.70710678f;
+static constexpr ProbeRotation probeRotations[8] = {
+    { HALF_SQRT2, HALF_SQRT2 }, { HALF_SQRT2, -HALF_SQRT2 },
+    { 0.f, 1.f }, { 0.f, -1.f },
+    { -HALF_SQRT2, HALF_SQRT2 }, { -HALF_SQRT2, -HALF_SQRT2 },
+    { -1.f, 0.f }, { 1.f, 0.f }
+};
+
+// 一次最多取出的附近障碍物数量，更多时改用网格逐个查询
+static const size_t MAX_NEARBY_OBSTACLES = 16;
+
+sf::Vector2f MonsterStore::findAlternativeDirection(size_t i, const sf::Vector2f& originalDir, const ObstacleGrid& obstacles) const {
+    const float step = 5.0f;
+
+    // 所有探测位置都在怪物周围 step 范围内，先一次取出这个范围里的障碍物
+    sf::FloatRect area(x[i] - step, y[i] - step, w[i] + step * 2, h[i] + step * 2);
+    sf::FloatRect nearby[MAX_NEARBY_OBSTACLES];
+    size_t nearbyCount = obstacles.collect(area, nearby, MAX_NEARBY_OBSTACLES);
+    bool useGrid = nearbyCount > MAX_NEARBY_OBSTACLES;
+
+    for (const ProbeRotation& rotation : probeRotations) {
+        sf::Vector2f newDir(rotation.c * originalDir.x - rotation.s * originalDir.y,
+            rotation.s * originalDir.x + rotation.c * originalDir.y);
+
+        // 检查新方向是否可行 (不出界、不碰障碍物)
+        sf::FloatRect box(x[i] + newDir.x * step, y[i] + newDir.y * step, w[i], h[i]);
+        if (box.left < 0 || box.left + box.width > static_cast<float>(MAP_WIDTH) ||
+            box.top < 0 || box.top + box.height > static_cast<float>(MAP_HEIGHT)) {
+            continue;
+        }
+
+        bool blocked = false;
+        if (useGrid) {
+            blocked = obstacles.intersects(box);
+        }
+        else {
+            for (size_t k = 0; k < nearbyCount && !blocked; ++k) {
+                blocked = nearby[k].intersects(box);
+            }
+        }
+        if (!blocked) {
+            return newDir;
+        }
+    }
+
+    return sf::Vector2f(0, 0); // 如果没有找到可行方向，返回零向量
+}
+
+void MonsterStore::chooseWaypoint(size_t i, const FlowField& flowField) {
+    // 流场给出的下一个格子中心 (换算成左上角坐标，与 target 一致)
+    sf::Vector2f waypoint;
+    if (flowField.nextWaypoint(getCenter(i), waypoint)) {
+        goalX[i] = waypoint.x - w[i] / 2.f;
+        goalY[i] = waypoint.y - h[i] / 2.f;
+        flags[i] |= HAS_WAYPOINT;
+    }
+    else {
+        flags[i] &= ~HAS_WAYPOINT;
+    }
+}
+
+void MonsterStore::think(size_t i, const FlowField& flowField, uint64_t tickSeed) {
+    if (flags[i] & TELEPORTING) {
+        return;
+    }
+    chooseWaypoint(i, flowField);
+
+    if ((monsterKindAbilities[kind[i]] & ABILITY_TELEPORT) && cooldown[i] == 0 &&
+        Rng::hashInt(tickSeed, i, 100) < TELEPORT_CHANCE) {
+        flags[i] = TELEPORTING;
+        timer[i] = 0;
+    }
+}
+
+void MonsterStore::moveTowards(size_t i, const sf::Vector2f& target, const FlowField& flowField, const ObstacleGrid& obstacles, int steps) {
+    float speed = monsterKindSpeeds[kind[i]] * steps;
+
+    sf::Vector2f goal = target;
+    if (flags[i] & HAS_WAYPOINT) {
+        goal = sf::Vector2f(goalX[i], goalY[i]);
+        // 这一帧就能走到路点时提前选下一个，不在格子中心停顿
+        sf::Vector2f offset = goal - getPosition(i);
+        if (offset.x * offset.x + offset.y * offset.y <= speed * speed) {
+            chooseWaypoint(i, flowField);
+            goal = (flags[i] & HAS_WAYPOINT) ? sf::Vector2f(goalX[i], goalY[i]) : target;
+        }
+    }
+
+    sf::Vector2f direction = goal - getPosition(i);
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+
+    if (length > 0) {
+        direction /= length;
+        sf::Vector2f newPos = getPosition(i) + direction * speed;
+
+        if (!checkObstacleCollision(sf::FloatRect(newPos.x, newPos.y, w[i], h[i]), obstacles)) {
+            // 如果没有碰到障碍物，则移动
+            if (newPos.x >= 0 && newPos.x + w[i] <= static_cast<float>(MAP_WIDTH)) {
+                x[i] += direction.x * speed;
+            }
+            if (newPos.y >= 0 && newPos.y + h[i] <= static_cast<float>(MAP_HEIGHT)) {
+                y[i] += direction.y * speed;
+            }
+        }
+        else {
+            // 如果碰到障碍物，寻找替代路径
+            sf::Vector2f alternativeDir = findAlternativeDirection(i, direction, obstacles);
+            if (alternativeDir.x != 0 || alternativeDir.y != 0) {
+                if (x[i] + alternativeDir.x >= 0 &&
+                    x[i] + alternativeDir.x + w[i] <= static_cast<float>(MAP_WIDTH)) {
+                    x[i] += alternativeDir.x * speed;
+                }
+                if (y[i] + alternativeDir.y >= 0 &&
+                    y[i] + alternativeDir.y + h[i] <= static_cast<float>(MAP_HEIGHT)) {
+                    y[i] += alternativeDir.y * speed;
+                }
+            }
+        }
+    }
+}
+
+bool MonsterStore::updateTeleport(size_t i, const sf::Vector2f& target, const ObstacleGrid& obstacles, int steps,
+    std::vector<MonsterCommand>& out) {
+    if (flags[i] & TELEPORTING) {
+        timer[i] += steps;
+
+        if (!(flags[i] & TELEPORT_START_SHOWN)) {
+            out.push_back(MonsterCommand{ MonsterCommand::TELEPORT_EFFECT, static_cast<uint32_t>(i), getCenter(i), sf::Vector2f() });
+            flags[i] |= TELEPORT_START_SHOWN;
+        }
+
+        if (timer[i] >= 90) {
+            sf::Vector2f newPos = target;
+            newPos.x -= w[i] / 2;
+            newPos.y -= h[i] / 2;
+
+            // 检查传送目标位置是否与障碍物碰撞
+            if (!checkObstacleCollision(sf::FloatRect(newPos.x, newPos.y, w[i], h[i]), obstacles)) {
+                x[i] = newPos.x;
+                y[i] = newPos.y;
+                out.push_back(MonsterCommand{ MonsterCommand::TELEPORT_EFFECT, static_cast<uint32_t>(i), getCenter(i), sf::Vector2f() });
+            }
+
+            // 传送后原来的路点作废，下次决策前直接朝目标走
+            flags[i] = 0;
+            timer[i] = 0;
+            cooldown[i] = 600;
+        }
+        return true;
+    }
+
+    cooldown[i] = std::max(0, cooldown[i] - steps);
+    return false;
+}
+
+void MonsterStore::shoot(size_t i, const sf::Vector2f& target, int steps, std::vector<MonsterCommand>& out) {
+    timer[i] += steps;
+    if (timer[i] >= SHOOT_INTERVAL) {
+        out.push_back(MonsterCommand{ MonsterCommand::SHOOT, static_cast<uint32_t>(i), getPosition(i), target });
+        timer[i] = 0;
+    }
+}
+
+void MonsterStore::update(const sf::Vector2f& target, const FlowField& flowField, ParticlePool& particles, std::vector<Bullet>& bullets,
+    const ObstacleGrid& obstacles, const sf::FloatRect& fullRateArea, const sf::FloatRect& activeArea,
+    unsigned long long tick, uint64_t tickSeed) {
+    JobSystem& jobs = JobSystem::instance();
+    threadCommands.resize(jobs.getThreadCount());
+    for (auto& buffer : threadCommands) {
+        buffer.clear();
+    }
+
+    // 一次更新最多移动几个像素 (远处的怪物一次走 FAR_UPDATE_INTERVAL 帧)，
+    // 包围盒外扩这么多还在活动区域内的怪物才更新，不会走进没有加载的区块
+    const float margin = 8.f;
+    const int farInterval = FAR_UPDATE_INTERVAL;
+    const int thinkInterval = THINK_INTERVAL;
+    // 每只怪物只读写自己的那一行，障碍物、流场和目标在更新期间只读
+    jobs.parallelFor(size(), UPDATE_GRAIN, [&](size_t begin, size_t end) {
+        std::vector<MonsterCommand>& out = threadCommands[JobSystem::threadIndex()];
+        for (size_t i = begin; i < end; ++i) {
+            int steps = 1;
+            if (!fullRateArea.contains(getCenter(i))) {
+                sf::FloatRect box(x[i] - margin, y[i] - margin, w[i] + margin * 2, h[i] + margin * 2);
+                bool active = box.left >= activeArea.left && box.top >= activeArea.top &&
+                    box.left + box.width <= activeArea.left + activeArea.width &&
+                    box.top + box.height <= activeArea.top + activeArea.height;
+                if (!active || (tick + i) % farInterval != 0) {
+                    continue;
+                }
+                // 降频更新：一次推进 FAR_UPDATE_INTERVAL 帧的移动和计时，速度与每帧更新时相同
+                steps = farInterval;
+            }
+
+            if ((tick + i) % thinkInterval == 0) {
+                think(i, flowField, tickSeed);
+            }
+
+            const unsigned char abilities = monsterKindAbilities[kind[i]];
+            if ((abilities & ABILITY_TELEPORT) && updateTeleport(i, target, obstacles, steps, out)) {
+                continue;
+            }
+            moveTowards(i, target, flowField, obstacles, steps);
+            if (abilities & ABILITY_SHOOT) {
+                shoot(i, target, steps, out);
+            }
+        }
+    });
+
+    // 按怪物下标合并各线程的命令，生成的子弹和粒子顺序与逐个更新时相同
+    commands.clear();
+    for (const auto& buffer : threadCommands) {
+        commands.insert(commands.end(), buffer.begin(), buffer.end());
+    }
+    std::sort(commands.begin(), commands.end(), [](const MonsterCommand& a, const MonsterCommand& b) {
+        return a.monster != b.monster ? a.monster < b.monster : a.type < b.type;
+    });
+
+    // 射击的视线检测：子弹的包围盒从发射位置平移到目标，与子弹实际飞过的范围相同
+    const sf::Vector2f bulletSize(Bullet::SIZE, Bullet::SIZE);
+    shotSweeps.clear();
+    for (const MonsterCommand& command : commands) {
+        if (command.type == MonsterCommand::SHOOT) {
+            shotSweeps.push_back(SweepQuery{ sf::FloatRect(command.position, bulletSize), command.target - command.position });
+        }
+    }
+    shotHits.resize(shotSweeps.size());
+    obstacles.castBox(shotSweeps.data(), shotSweeps.size(), shotHits.data());
+
+    size_t shot = 0;
+    for (const MonsterCommand& command : commands) {
+        if (command.type == MonsterCommand::SHOOT) {
+            if (shotHits[shot++].t < 1.f) {
+                // 被挡住：子弹只会撞在障碍物上，不发射，下次决策的间隔之后再试
+                timer[command.monster] = SHOOT_INTERVAL - THINK_INTERVAL;
+                continue;
+            }
+            bullets.emplace_back(command.position, command.target);
+        }
+        else {
+            emitTeleportEffect(particles, command.position);
+        }
+    }
+}
+
+void MonsterStore::appendTo(ShapeBatch& batch, const sf::FloatRect& area) const {
+    for (size_t i = 0; i < size(); ++i) {
+        if (getBounds(i).intersects(area)) {
+            batch.addRect(getBounds(i), monsterKindColors[kind[i]]);
+        }
+    }
+}
+
+// MonsterGrid实现
+MonsterGrid::MonsterGrid() : cols(1), rows(1) {
+    cellStart.resize(cols * rows + 1);
+}
+
+void MonsterGrid::rebuild(const MonsterStore& monsters, const sf::FloatRect& area) {
+    store = &monsters;
+    origin = sf::Vector2f(area.left, area.top);
+    cols = std::max(1, static_cast<int>(std::ceil(area.width / CELL_SIZE)));
+    rows = std::max(1, static_cast<int>(std::ceil(area.height / CELL_SIZE)));
+    cellStart.resize(cols * rows + 1);
+
+    // 计数排序：按格子把怪物编号排成连续数组
+    size_t count = monsters.size();
+    maxWidth = 0.f;
+    maxHeight = 0.f;
+    cellOf.resize(count);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for (size_t i = 0; i < count; ++i) {
+        cellOf[i] = cellIndex(monsters.x[i], monsters.y[i]);
+        cellStart[cellOf[i] + 1]++;
+        maxWidth = std::max(maxWidth, monsters.w[i]);
+        maxHeight = std::max(maxHeight, monsters.h[i]);
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    sorted.resize(count);
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        sorted[cursor[cellOf[i]]++] = static_cast<int>(i);
+    }
+    hit.assign(count, 0);
+}
+
+int MonsterGrid::findFirstHit(const sf::FloatRect& box) const {
+    int x0 = clampCell(static_cast<int>(std::floor((box.left - maxWidth - origin.x) / CELL_SIZE)), cols);
+    int y0 = clampCell(static_cast<int>(std::floor((box.top - maxHeight - origin.y) / CELL_SIZE)), rows);
+    int x1 = clampCell(static_cast<int>(std::floor((box.left + box.width - origin.x) / CELL_SIZE)), cols);
+    int y1 = clampCell(static_cast<int>(std::floor((box.top + box.height - origin.y) / CELL_SIZE)), rows);
+
+    int best = -1;
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            int cell = cy * cols + cx;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                int id = sorted[k];
+                if (hit[id] || (best >= 0 && !isBefore(id, best))) {
+                    continue;
+                }
+                if (store->getBounds(id).intersects(box)) {
+                    best = id;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+bool MonsterGrid::isBefore(int a, int b) const {
+    return store->kind[a] != store->kind[b] ? store->kind[a] < store->kind[b] : a < b;
+}
+
+int MonsterGrid::cellIndex(float x, float y) const {
+    int cx = clampCell(static_cast<int>(std::floor((x - origin.x) / CELL_SIZE)), cols);
+    int cy = clampCell(static_cast<int>(std::floor((y - origin.y) / CELL_SIZE)), rows);
+    return cy * cols + cx;
+}
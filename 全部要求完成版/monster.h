@@ -0,0 +1,165 @@
+#ifndef MONSTER_H
+#define MONSTER_H
+
+#include "game.h"
+#include "obstacle.h"
+#include "bullet.h"
+#include "effects.h"
+#include "flowfield.h"
+#include <vector>
+
+// 怪物种类 (同时决定子弹命中时的检查顺序)
+enum MonsterKind {
+    BLUE_MONSTER,
+    RED_MONSTER,
+    YELLOW_MONSTER,
+    RANGED_MONSTER,
+    MONSTER_KIND_COUNT
+};
+
+// 怪物的能力 (AI 按种类查表执行，不按种类分支)
+enum MonsterAbility : unsigned char {
+    ABILITY_TELEPORT = 1,   // 随机蓄力后传送到目标位置
+    ABILITY_SHOOT = 2       // 定时向目标射击
+};
+
+// 每种怪物的颜色、移动速度和能力
+extern const sf::Color monsterKindColors[MONSTER_KIND_COUNT];
+extern const float monsterKindSpeeds[MONSTER_KIND_COUNT];
+extern const unsigned char monsterKindAbilities[MONSTER_KIND_COUNT];
+
+// 怪物更新时产生的副作用：先记在各线程自己的缓冲里，所有怪物更新完后按怪物下标合并执行，
+// 结果与线程数和任务的执行顺序无关
+struct MonsterCommand {
+    enum Type : unsigned char {
+        SHOOT,             // 从 position 向 target 发射子弹
+        TELEPORT_EFFECT    // 在 position 播放传送特效
+    };
+
+    Type type;
+    uint32_t monster;      // 怪物下标 (合并时排序用)
+    sf::Vector2f position;
+    sf::Vector2f target;
+};
+
+// 怪物存储 (结构数组)：所有种类的怪物放在同一组连续数组里，
+// 移动和碰撞只读写需要的列，图形只在绘制时临时构造。
+// AI 分两层：决策 (选路点、传送判定) 每 THINK_INTERVAL 帧做一次，按下标错开到各帧；
+// 移动、碰撞和计时每帧执行，只使用上次决策的结果
+struct MonsterStore {
+    // 怪物的状态标记
+    enum Flags : unsigned char {
+        TELEPORTING = 1,           // 蓝色：正在蓄力传送
+        TELEPORT_START_SHOWN = 2,  // 蓝色：已播放蓄力特效
+        HAS_WAYPOINT = 4           // goalX/goalY 是流场给出的路点，否则直接朝目标走
+    };
+
+    // 活动区域内、玩家附近以外的怪物每隔这么多帧才更新一次 (按下标错开)
+    static const int FAR_UPDATE_INTERVAL = 4;
+    // 每只怪物每隔这么多帧决策一次 (FAR_UPDATE_INTERVAL 的倍数，远处的怪物也在更新的那帧决策)
+    static const int THINK_INTERVAL = 8;
+    // 每次决策开始传送的概率 (百分比，约等于每帧1%连续 THINK_INTERVAL 帧)
+    static const int TELEPORT_CHANCE = 8;
+    // 远程怪物的射击间隔 (帧)；射击时看不见目标就不发射，过 THINK_INTERVAL 帧再检查
+    static const int SHOOT_INTERVAL = 60;
+    // 并行更新时每个任务负责的怪物数
+    static const size_t UPDATE_GRAIN = 64;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> w;
+    std::vector<float> h;
+    std::vector<unsigned char> kind;
+    std::vector<int> timer;            // 蓝色：传送计时；远程：射击计时
+    std::vector<int> cooldown;         // 蓝色：传送冷却
+    std::vector<unsigned char> flags;  // Flags
+    std::vector<float> goalX;          // 决策时选定的路点 (左上角坐标)
+    std::vector<float> goalY;
+
+    std::vector<std::vector<MonsterCommand>> threadCommands;  // 每个线程一个命令缓冲
+    std::vector<MonsterCommand> commands;                     // 合并后的命令
+    std::vector<SweepQuery> shotSweeps;                       // 本帧射击的视线检测 (批量查询)
+    std::vector<RayHit> shotHits;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void clear();
+    void add(MonsterKind monsterKind, const sf::Vector2f& position);
+
+    // 在不与障碍物重叠的随机位置生成一只怪物，没有空位时返回 false
+    bool spawn(MonsterKind monsterKind, const SpawnSampler& spawns, Rng& rng);
+    // 在 area 内每种怪物各生成 countPerKind 只 (空位只计算一次)
+    void spawnWave(int countPerKind, const ObstacleGrid& obstacles, const sf::FloatRect& area, Rng& rng);
+
+    // 用最后一只怪物覆盖第 i 只再弹出
+    void removeSwap(size_t i);
+
+    sf::Vector2f getPosition(size_t i) const { return sf::Vector2f(x[i], y[i]); }
+    sf::Vector2f getCenter(size_t i) const { return sf::Vector2f(x[i] + w[i] / 2.f, y[i] + h[i] / 2.f); }
+    sf::FloatRect getBounds(size_t i) const { return sf::FloatRect(x[i], y[i], w[i], h[i]); }
+
+    // 寻找替代移动方向：按固定顺序旋转原方向，只和怪物附近的障碍物比较
+    sf::Vector2f findAlternativeDirection(size_t i, const sf::Vector2f& originalDir, const ObstacleGrid& obstacles) const;
+    // 从流场取下一个格子的中心作为路点，已经在目标格子 (或不在流场里) 时清除路点
+    void chooseWaypoint(size_t i, const FlowField& flowField);
+    // 决策：重新选路点；会传送的怪物冷却结束后随机进入传送状态 (概率由本帧种子和怪物下标算出)
+    void think(size_t i, const FlowField& flowField, uint64_t tickSeed);
+    // 朝路点移动 steps 帧的距离，到达路点时立即选下一个；没有路点时直接朝目标走
+    void moveTowards(size_t i, const sf::Vector2f& target, const FlowField& flowField, const ObstacleGrid& obstacles, int steps = 1);
+    // 传送计时 (推进 steps 帧)：蓄力90帧后传送到目标位置，否则冷却减少。蓄力中 (本次不移动) 返回 true
+    bool updateTeleport(size_t i, const sf::Vector2f& target, const ObstacleGrid& obstacles, int steps,
+        std::vector<MonsterCommand>& out);
+    // 远程怪物：每 SHOOT_INTERVAL 帧准备向目标射击一次 (合并命令时检查视线)
+    void shoot(size_t i, const sf::Vector2f& target, int steps, std::vector<MonsterCommand>& out);
+
+    // 怪物决策和移动 (远程怪物同时射击)，分块并行执行，子弹和特效在全部更新完后按怪物下标生成，
+    // 生成子弹前一起对子弹的飞行路线做视线检测 (ObstacleGrid::castBox)，被障碍物挡住的不发射。
+    // 下标 i 的怪物在 (tick + i) % THINK_INTERVAL == 0 的帧决策，每帧决策的怪物数约为总数的 1/THINK_INTERVAL。
+    // tickSeed 每帧从 AI 随机数流取一次，随机行为由它和怪物下标决定。
+    // 中心在 fullRateArea 内的怪物每帧更新，其余在 activeArea 内的每 FAR_UPDATE_INTERVAL 帧更新一次
+    // (一次推进 FAR_UPDATE_INTERVAL 帧，移动速度和计时不变，只是更粗)，
+    // 更远的怪物所在区块的障碍物不参与碰撞，暂停不动
+    void update(const sf::Vector2f& target, const FlowField& flowField, ParticlePool& particles, std::vector<Bullet>& bullets,
+        const ObstacleGrid& obstacles, const sf::FloatRect& fullRateArea, const sf::FloatRect& activeArea,
+        unsigned long long tick, uint64_t tickSeed);
+
+    // 把与区域相交的怪物追加到图形批次 (只画视野内的)
+    void appendTo(ShapeBatch& batch, const sf::FloatRect& area) const;
+};
+
+// 怪物松散网格：每帧按左上角重建，用于子弹命中检测。
+// 网格只覆盖子弹所在的区域 (活动区块)，区域外的怪物夹到边缘的格子里
+class MonsterGrid {
+public:
+    static const int CELL_SIZE = 64;
+
+    MonsterGrid();
+
+    void rebuild(const MonsterStore& monsters, const sf::FloatRect& area);
+
+    // 找出与包围盒相交且尚未被击中的怪物，多个时取种类和下标最小的一个 (与逐类逐个检查的顺序一致)
+    // 返回怪物下标，没有命中返回 -1
+    int findFirstHit(const sf::FloatRect& box) const;
+
+    void markHit(int id) { hit[id] = 1; }
+    bool isHit(size_t id) const { return hit[id] != 0; }
+
+private:
+    const MonsterStore* store = nullptr;
+    std::vector<int> cellOf;
+    std::vector<int> cellStart;          // 每个格子在 sorted 中的起始位置
+    std::vector<int> cursor;
+    std::vector<int> sorted;
+    std::vector<char> hit;               // 本帧已被击中的怪物
+    float maxWidth = 0.f;
+    float maxHeight = 0.f;
+    sf::Vector2f origin;
+    int cols;
+    int rows;
+
+    bool isBefore(int a, int b) const;
+    int cellIndex(float x, float y) const;
+};
+
+#endif // MONSTER_H
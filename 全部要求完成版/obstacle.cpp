@@ -0,0 +1,523 @@
+#include "obstacle.h"
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+static int clampCell(int cell, int count) {
+    return cell < 0 ? 0 : (cell >= count ? count - 1 : cell);
+}
+
+Obstacle::Obstacle(float x, float y, float width, float height) {
+    shape.setPosition(x, y);
+    shape.setSize(sf::Vector2f(width, height));
+    shape.setFillColor(sf::Color::White);
+}
+
+bool Obstacle::intersects(const sf::RectangleShape& other) const {
+    return shape.getGlobalBounds().intersects(other.getGlobalBounds());
+}
+
+ObstacleGrid::ObstacleGrid() : level(1), seed(0), centerX(-1), centerY(-1), obstacleCount(0), loadedChunks(0) {
+    chunkCols = (MAP_WIDTH + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunkRows = (MAP_HEIGHT + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunks.resize(chunkCols * chunkRows);
+}
+
+void ObstacleGrid::reset(int newLevel, uint64_t newSeed) {
+    clear();
+    level = newLevel;
+    seed = newSeed;
+}
+
+void ObstacleGrid::clear() {
+    for (auto& chunk : chunks) {
+        chunk = Chunk();
+    }
+    centerX = -1;
+    centerY = -1;
+    obstacleCount = 0;
+    loadedChunks = 0;
+}
+
+bool ObstacleGrid::streamAround(const sf::Vector2f& center) {
+    int chunkX = clampCell(static_cast<int>(std::floor(center.x / CHUNK_SIZE)), chunkCols);
+    int chunkY = clampCell(static_cast<int>(std::floor(center.y / CHUNK_SIZE)), chunkRows);
+    if (chunkX == centerX && chunkY == centerY) {
+        return false;
+    }
+    centerX = chunkX;
+    centerY = chunkY;
+
+    for (int cy = 0; cy < chunkRows; ++cy) {
+        for (int cx = 0; cx < chunkCols; ++cx) {
+            int ring = std::max(std::abs(cx - centerX), std::abs(cy - centerY));
+            bool loaded = chunks[cy * chunkCols + cx].loaded;
+            if (loaded && ring > EVICT_RADIUS) {
+                unloadChunk(cx, cy);
+            }
+            else if (!loaded && ring <= ACTIVE_RADIUS) {
+                loadChunk(cx, cy);
+            }
+        }
+    }
+    return true;
+}
+
+sf::FloatRect ObstacleGrid::getChunkArea(int radius) const {
+    if (centerX < 0) {
+        return sf::FloatRect();
+    }
+    float left = static_cast<float>(std::max(centerX - radius, 0) * CHUNK_SIZE);
+    float top = static_cast<float>(std::max(centerY - radius, 0) * CHUNK_SIZE);
+    float right = static_cast<float>(std::min((centerX + radius + 1) * CHUNK_SIZE, MAP_WIDTH));
+    float bottom = static_cast<float>(std::min((centerY + radius + 1) * CHUNK_SIZE, MAP_HEIGHT));
+    return sf::FloatRect(left, top, right - left, bottom - top);
+}
+
+bool ObstacleGrid::intersects(const sf::FloatRect& box) const {
+    int x0, y0, x1, y1;
+    chunkRange(box, x0, y0, x1, y1);
+    for (int chunkY = y0; chunkY <= y1; ++chunkY) {
+        for (int chunkX = x0; chunkX <= x1; ++chunkX) {
+            const Chunk* chunk = activeChunk(chunkX, chunkY);
+            if (chunk && chunkIntersects(*chunk, chunkX, chunkY, box)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t ObstacleGrid::collect(const sf::FloatRect& area, sf::FloatRect* out, size_t maxCount) const {
+    size_t count = 0;
+    int chunkX0, chunkY0, chunkX1, chunkY1;
+    chunkRange(area, chunkX0, chunkY0, chunkX1, chunkY1);
+    for (int chunkY = chunkY0; chunkY <= chunkY1; ++chunkY) {
+        for (int chunkX = chunkX0; chunkX <= chunkX1; ++chunkX) {
+            const Chunk* chunk = activeChunk(chunkX, chunkY);
+            if (!chunk) {
+                continue;
+            }
+            int x0, y0, x1, y1;
+            cellRange(area, chunkX, chunkY, x0, y0, x1, y1);
+            for (int cy = y0; cy <= y1; ++cy) {
+                for (int cx = x0; cx <= x1; ++cx) {
+                    for (int index : chunk->cells[cy * CHUNK_CELLS + cx]) {
+                        // 跨多个格子的障碍物只在它与查询范围重叠的第一个格子里计数
+                        int ox0, oy0, ox1, oy1;
+                        cellRange(chunk->bounds[index], chunkX, chunkY, ox0, oy0, ox1, oy1);
+                        if (cx != std::max(x0, ox0) || cy != std::max(y0, oy0)) {
+                            continue;
+                        }
+                        if (chunk->bounds[index].intersects(area)) {
+                            if (count < maxCount) {
+                                out[count] = chunk->bounds[index];
+                            }
+                            count++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+void ObstacleGrid::query(const sf::FloatRect& area, std::vector<sf::FloatRect>& out) const {
+    int x0, y0, x1, y1;
+    chunkRange(area, x0, y0, x1, y1);
+    for (int chunkY = y0; chunkY <= y1; ++chunkY) {
+        for (int chunkX = x0; chunkX <= x1; ++chunkX) {
+            const Chunk* chunk = activeChunk(chunkX, chunkY);
+            if (!chunk) {
+                continue;
+            }
+            for (const sf::FloatRect& bounds : chunk->bounds) {
+                if (bounds.intersects(area)) {
+                    out.push_back(bounds);
+                }
+            }
+        }
+    }
+}
+
+// 线段 from + delta * t (t 在 [0, tLimit) 内) 与矩形的第一个交点 (分轴求进入和离开的参数)
+static bool segmentHitsBox(const sf::Vector2f& from, const sf::Vector2f& delta, const sf::FloatRect& box, float tLimit,
+    float& tHit, sf::Vector2f& normal) {
+    float tEnter = 0.f;
+    float tExit = tLimit;
+    sf::Vector2f enterNormal(0.f, 0.f);
+
+    const float start[2] = { from.x, from.y };
+    const float d[2] = { delta.x, delta.y };
+    const float low[2] = { box.left, box.top };
+    const float high[2] = { box.left + box.width, box.top + box.height };
+    for (int axis = 0; axis < 2; ++axis) {
+        if (d[axis] == 0.f) {
+            // 与这条轴平行：起点不在矩形的范围内就不会相交
+            if (start[axis] <= low[axis] || start[axis] >= high[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float inv = 1.f / d[axis];
+        float t0 = (low[axis] - start[axis]) * inv;
+        float t1 = (high[axis] - start[axis]) * inv;
+        float side = -1.f;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+            side = 1.f;
+        }
+        if (t0 > tEnter) {
+            tEnter = t0;
+            enterNormal = axis == 0 ? sf::Vector2f(side, 0.f) : sf::Vector2f(0.f, side);
+        }
+        tExit = std::min(tExit, t1);
+        if (tEnter >= tExit) {
+            return false;
+        }
+    }
+    tHit = tEnter;
+    normal = enterNormal;
+    return true;
+}
+
+// 沿一条 DDA 路径检查障碍物：corner 是移动包围盒 box 的一个角，沿 delta 走过的格子里的障碍物
+// 按包围盒的尺寸扩大后与左上角的线段求交，结果合并到 best
+void ObstacleGrid::castCorner(const sf::Vector2f& corner, const sf::FloatRect& box, const sf::Vector2f& delta,
+    RayHit& best, bool& blocked) const {
+    // 障碍物都在地图内，先把线段裁到地图范围
+    float tStart, tBack;
+    sf::Vector2f unused;
+    const sf::FloatRect map(0.f, 0.f, static_cast<float>(MAP_WIDTH), static_cast<float>(MAP_HEIGHT));
+    if (centerX < 0 || !segmentHitsBox(corner, delta, map, 1.f, tStart, unused)) {
+        return;
+    }
+    // 线段离开地图的位置 (反向再求一次进入点)
+    segmentHitsBox(corner + delta, -delta, map, 1.f, tBack, unused);
+    const float tEnd = 1.f - tBack;
+
+    const sf::Vector2f origin(box.left, box.top);
+    const int cols = chunkCols * CHUNK_CELLS;
+    const int rows = chunkRows * CHUNK_CELLS;
+    const float cellSize = static_cast<float>(CELL_SIZE);
+    const sf::Vector2f first = corner + delta * tStart;
+    int cx = clampCell(static_cast<int>(std::floor(first.x / cellSize)), cols);
+    int cy = clampCell(static_cast<int>(std::floor(first.y / cellSize)), rows);
+
+    // DDA：tNextX/tNextY 是线段穿过下一条竖/横格线时的参数
+    const int stepX = delta.x > 0.f ? 1 : -1;
+    const int stepY = delta.y > 0.f ? 1 : -1;
+    const float infinity = std::numeric_limits<float>::infinity();
+    const float tDeltaX = delta.x != 0.f ? cellSize / std::abs(delta.x) : infinity;
+    const float tDeltaY = delta.y != 0.f ? cellSize / std::abs(delta.y) : infinity;
+    float tNextX = delta.x != 0.f ? ((cx + (stepX > 0 ? 1 : 0)) * cellSize - corner.x) / delta.x : infinity;
+    float tNextY = delta.y != 0.f ? ((cy + (stepY > 0 ? 1 : 0)) * cellSize - corner.y) / delta.y : infinity;
+
+    for (int visited = 0; visited <= cols + rows; ++visited) {
+        const int chunkX = cx / CHUNK_CELLS;
+        const int chunkY = cy / CHUNK_CELLS;
+        if (const Chunk* chunk = activeChunk(chunkX, chunkY)) {
+            const int cell = (cy - chunkY * CHUNK_CELLS) * CHUNK_CELLS + (cx - chunkX * CHUNK_CELLS);
+            for (int index : chunk->cells[cell]) {
+                const sf::FloatRect& bounds = chunk->bounds[index];
+                const sf::FloatRect expanded(bounds.left - box.width, bounds.top - box.height,
+                    bounds.width + box.width, bounds.height + box.height);
+                float t;
+                sf::Vector2f normal;
+                if (segmentHitsBox(origin, delta, expanded, best.t, t, normal)) {
+                    best.t = t;
+                    best.normal = normal;
+                    blocked = true;
+                }
+            }
+        }
+
+        // 跨格子的障碍物可能在后面的格子里才被找到，命中点在当前格子以内才能停
+        const float tLeave = std::min(tNextX, tNextY);
+        if ((blocked && best.t <= tLeave) || tLeave >= tEnd) {
+            break;
+        }
+        if (tNextX < tNextY) {
+            cx += stepX;
+            tNextX += tDeltaX;
+        }
+        else {
+            cy += stepY;
+            tNextY += tDeltaY;
+        }
+        if (cx < 0 || cx >= cols || cy < 0 || cy >= rows) {
+            break;
+        }
+    }
+}
+
+bool ObstacleGrid::castBox(const sf::FloatRect& box, const sf::Vector2f& delta, RayHit* hit) const {
+    // 包围盒比格子大时四个角之间可能隔着整个格子，改为检查扫过的整个范围
+    if (box.width > CELL_SIZE || box.height > CELL_SIZE) {
+        return sweep(box, delta, hit);
+    }
+
+    RayHit best;
+    bool blocked = false;
+    const sf::Vector2f corners[4] = {
+        sf::Vector2f(box.left, box.top), sf::Vector2f(box.left + box.width, box.top),
+        sf::Vector2f(box.left, box.top + box.height), sf::Vector2f(box.left + box.width, box.top + box.height)
+    };
+    // 包围盒不比格子大时，扫过范围碰到的每个格子都在某个角的路径上
+    for (int k = 0; k < 4; ++k) {
+        castCorner(corners[k], box, delta, best, blocked);
+    }
+
+    if (hit) {
+        hit->t = best.t;
+        hit->point = sf::Vector2f(box.left, box.top) + delta * best.t;
+        hit->normal = best.normal;
+    }
+    return blocked;
+}
+
+size_t ObstacleGrid::castBox(const SweepQuery* casts, size_t count, RayHit* hits) const {
+    size_t blockedCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (castBox(casts[i].box, casts[i].delta, &hits[i])) {
+            blockedCount++;
+        }
+    }
+    return blockedCount;
+}
+
+bool ObstacleGrid::sweep(const sf::FloatRect& box, const sf::Vector2f& delta, RayHit* hit) const {
+    const sf::Vector2f from(box.left, box.top);
+    float bestT = 1.f;
+    sf::Vector2f bestNormal(0.f, 0.f);
+    bool blocked = false;
+
+    // 起点和终点的包围盒合起来就是扫过的范围
+    const sf::FloatRect swept(std::min(box.left, box.left + delta.x), std::min(box.top, box.top + delta.y),
+        box.width + std::abs(delta.x), box.height + std::abs(delta.y));
+    int chunkX0, chunkY0, chunkX1, chunkY1;
+    chunkRange(swept, chunkX0, chunkY0, chunkX1, chunkY1);
+    for (int chunkY = chunkY0; chunkY <= chunkY1; ++chunkY) {
+        for (int chunkX = chunkX0; chunkX <= chunkX1; ++chunkX) {
+            const Chunk* chunk = activeChunk(chunkX, chunkY);
+            if (!chunk) {
+                continue;
+            }
+            int x0, y0, x1, y1;
+            cellRange(swept, chunkX, chunkY, x0, y0, x1, y1);
+            for (int cy = y0; cy <= y1; ++cy) {
+                for (int cx = x0; cx <= x1; ++cx) {
+                    for (int index : chunk->cells[cy * CHUNK_CELLS + cx]) {
+                        // 障碍物向左上扩大包围盒的尺寸，包围盒与它相交等价于左上角落在扩大后的矩形里
+                        const sf::FloatRect& bounds = chunk->bounds[index];
+                        const sf::FloatRect expanded(bounds.left - box.width, bounds.top - box.height,
+                            bounds.width + box.width, bounds.height + box.height);
+                        float t;
+                        sf::Vector2f normal;
+                        if (segmentHitsBox(from, delta, expanded, bestT, t, normal)) {
+                            bestT = t;
+                            bestNormal = normal;
+                            blocked = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (hit) {
+        hit->t = bestT;
+        hit->point = from + delta * bestT;
+        hit->normal = bestNormal;
+    }
+    return blocked;
+}
+
+void ObstacleGrid::appendTo(ShapeBatch& batch, const sf::FloatRect& area) const {
+    int x0, y0, x1, y1;
+    chunkRange(area, x0, y0, x1, y1);
+    for (int chunkY = y0; chunkY <= y1; ++chunkY) {
+        for (int chunkX = x0; chunkX <= x1; ++chunkX) {
+            const Chunk* chunk = activeChunk(chunkX, chunkY);
+            if (!chunk) {
+                continue;
+            }
+            for (size_t i = 0; i < chunk->obstacles.size(); ++i) {
+                if (chunk->bounds[i].intersects(area)) {
+                    batch.addRect(chunk->bounds[i], chunk->obstacles[i].getShape().getFillColor());
+                }
+            }
+        }
+    }
+}
+
+const ObstacleGrid::Chunk* ObstacleGrid::activeChunk(int chunkX, int chunkY) const {
+    if (centerX < 0 || std::abs(chunkX - centerX) > ACTIVE_RADIUS || std::abs(chunkY - centerY) > ACTIVE_RADIUS) {
+        return nullptr;
+    }
+    const Chunk& chunk = chunks[chunkY * chunkCols + chunkX];
+    return chunk.loaded ? &chunk : nullptr;
+}
+
+// 生成一个区块的障碍物：随机数流只由关卡种子和区块编号决定，与加载顺序无关
+void ObstacleGrid::loadChunk(int chunkX, int chunkY) {
+    Chunk& chunk = chunks[chunkY * chunkCols + chunkX];
+    chunk.loaded = true;
+    chunk.cells.resize(CHUNK_CELLS * CHUNK_CELLS);
+    loadedChunks++;
+
+    Rng rng(Rng::deriveSeed(seed, static_cast<uint64_t>(chunkY * chunkCols + chunkX)));
+    const int left = chunkX * CHUNK_SIZE;
+    const int top = chunkY * CHUNK_SIZE;
+    const int chunkSize = CHUNK_SIZE;
+    const int chunkWidth = std::min(chunkSize, MAP_WIDTH - left);
+    const int chunkHeight = std::min(chunkSize, MAP_HEIGHT - top);
+
+    // 原来一屏 (800x800) 放 5 + level*2 个障碍物 (每关增加)，按面积换算到每个区块；
+    // 不足一个的部分按比例随机多放一个，平均密度不变
+    const int screenArea = WINDOW_WIDTH * WINDOW_HEIGHT;
+    const int expected = (5 + level * 2) * chunkWidth * chunkHeight;
+    int numObstacles = expected / screenArea;
+    if (rng.nextInt(screenArea) < expected % screenArea) {
+        numObstacles++;
+    }
+
+    // 玩家出生点（地图中心）
+    const sf::FloatRect spawnArea(MAP_WIDTH / 2 - 50, MAP_HEIGHT / 2 - 50, 100, 100);
+
+    int failedInRow = 0;
+    for (int i = 0; i < numObstacles && failedInRow < MAX_FAILED_PLACEMENTS; ++i) {
+        // 与出生点或其他障碍物重叠时重新随机大小和位置，次数有上限；障碍物整个放在区块内
+        failedInRow++;
+        for (int attempt = 0; attempt < MAX_PLACEMENT_ATTEMPTS; ++attempt) {
+            float width = 30.0f + rng.nextInt(70); // 30-100的随机宽度
+            float height = 30.0f + rng.nextInt(70); // 30-100的随机高度
+            float x = static_cast<float>(left + rng.nextInt(chunkWidth - static_cast<int>(width)));
+            float y = static_cast<float>(top + rng.nextInt(chunkHeight - static_cast<int>(height)));
+            sf::FloatRect bounds(x, y, width, height);
+
+            if (!bounds.intersects(spawnArea) && !chunkIntersects(chunk, chunkX, chunkY, bounds)) {
+                addToChunk(chunk, chunkX, chunkY, Obstacle(x, y, width, height));
+                failedInRow = 0;
+                break;
+            }
+        }
+    }
+}
+
+void ObstacleGrid::unloadChunk(int chunkX, int chunkY) {
+    Chunk& chunk = chunks[chunkY * chunkCols + chunkX];
+    obstacleCount -= chunk.obstacles.size();
+    loadedChunks--;
+    chunk = Chunk();
+}
+
+void ObstacleGrid::addToChunk(Chunk& chunk, int chunkX, int chunkY, const Obstacle& obstacle) {
+    int index = static_cast<int>(chunk.obstacles.size());
+    chunk.obstacles.push_back(obstacle);
+    chunk.bounds.push_back(obstacle.getShape().getGlobalBounds());
+    obstacleCount++;
+
+    int x0, y0, x1, y1;
+    cellRange(chunk.bounds.back(), chunkX, chunkY, x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            chunk.cells[cy * CHUNK_CELLS + cx].push_back(index);
+        }
+    }
+}
+
+bool ObstacleGrid::chunkIntersects(const Chunk& chunk, int chunkX, int chunkY, const sf::FloatRect& box) const {
+    int x0, y0, x1, y1;
+    cellRange(box, chunkX, chunkY, x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            for (int index : chunk.cells[cy * CHUNK_CELLS + cx]) {
+                if (chunk.bounds[index].intersects(box)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void ObstacleGrid::chunkRange(const sf::FloatRect& box, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = clampCell(static_cast<int>(std::floor(box.left / CHUNK_SIZE)), chunkCols);
+    y0 = clampCell(static_cast<int>(std::floor(box.top / CHUNK_SIZE)), chunkRows);
+    x1 = clampCell(static_cast<int>(std::floor((box.left + box.width) / CHUNK_SIZE)), chunkCols);
+    y1 = clampCell(static_cast<int>(std::floor((box.top + box.height) / CHUNK_SIZE)), chunkRows);
+}
+
+void ObstacleGrid::cellRange(const sf::FloatRect& box, int chunkX, int chunkY, int& x0, int& y0, int& x1, int& y1) const {
+    const float left = static_cast<float>(chunkX * CHUNK_SIZE);
+    const float top = static_cast<float>(chunkY * CHUNK_SIZE);
+    x0 = clampCell(static_cast<int>(std::floor((box.left - left) / CELL_SIZE)), CHUNK_CELLS);
+    y0 = clampCell(static_cast<int>(std::floor((box.top - top) / CELL_SIZE)), CHUNK_CELLS);
+    x1 = clampCell(static_cast<int>(std::floor((box.left + box.width - left) / CELL_SIZE)), CHUNK_CELLS);
+    y1 = clampCell(static_cast<int>(std::floor((box.top + box.height - top) / CELL_SIZE)), CHUNK_CELLS);
+}
+
+bool checkObstacleCollision(const sf::FloatRect& bounds, const ObstacleGrid& obstacles) {
+    return obstacles.intersects(bounds);
+}
+
+bool checkObstacleCollision(const sf::RectangleShape& object, const ObstacleGrid& obstacles) {
+    return checkObstacleCollision(object.getGlobalBounds(), obstacles);
+}
+
+void SpawnSampler::build(const ObstacleGrid& obstacles, const sf::FloatRect& area, const sf::Vector2f& size) {
+    // 把区域分成 STEP×STEP 的小格，标记碰到障碍物的小格 (只擦到边的不算)，
+    // 再用二维前缀和判断物体覆盖的小格里有没有障碍物
+    const int cols = static_cast<int>(area.width) / STEP;
+    const int rows = static_cast<int>(area.height) / STEP;
+    const int stride = cols + 1;
+    freePositions.clear();
+    if (cols <= 0 || rows <= 0) {
+        return;
+    }
+
+    std::vector<sf::FloatRect> nearby;
+    obstacles.query(area, nearby);
+    std::vector<int> blocked(stride * (rows + 1), 0);
+    for (const sf::FloatRect& bounds : nearby) {
+        int x0 = clampCell(static_cast<int>(std::floor((bounds.left - area.left) / STEP)), cols);
+        int y0 = clampCell(static_cast<int>(std::floor((bounds.top - area.top) / STEP)), rows);
+        int x1 = clampCell(static_cast<int>(std::ceil((bounds.left + bounds.width - area.left) / STEP)) - 1, cols);
+        int y1 = clampCell(static_cast<int>(std::ceil((bounds.top + bounds.height - area.top) / STEP)) - 1, rows);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                blocked[(cy + 1) * stride + cx + 1] = 1;
+            }
+        }
+    }
+    for (int cy = 1; cy <= rows; ++cy) {
+        for (int cx = 1; cx <= cols; ++cx) {
+            blocked[cy * stride + cx] += blocked[(cy - 1) * stride + cx] + blocked[cy * stride + cx - 1] -
+                blocked[(cy - 1) * stride + cx - 1];
+        }
+    }
+
+    const int spanX = static_cast<int>(std::ceil(size.x / STEP));
+    const int spanY = static_cast<int>(std::ceil(size.y / STEP));
+    freePositions.reserve(cols * rows);
+    for (int cy = 0; cy + spanY <= rows; ++cy) {
+        for (int cx = 0; cx + spanX <= cols; ++cx) {
+            int count = blocked[(cy + spanY) * stride + cx + spanX] - blocked[cy * stride + cx + spanX] -
+                blocked[(cy + spanY) * stride + cx] + blocked[cy * stride + cx];
+            if (count == 0) {
+                freePositions.push_back(sf::Vector2f(area.left + cx * STEP, area.top + cy * STEP));
+            }
+        }
+    }
+}
+
+bool SpawnSampler::sample(Rng& rng, sf::Vector2f& position) const {
+    if (freePositions.empty()) {
+        return false;
+    }
+    position = freePositions[rng.nextInt(static_cast<int>(freePositions.size()))];
+    return true;
+}
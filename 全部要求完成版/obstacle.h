@@ -0,0 +1,144 @@
+#ifndef OBSTACLE_H
+#define OBSTACLE_H
+
+#include "game.h"
+#include "rng.h"
+#include "render.h"
+#include <vector>
+
+// 障碍物类
+class Obstacle {
+public:
+    Obstacle(float x, float y, float width, float height);
+
+    const sf::RectangleShape& getShape() const { return shape; }
+    bool intersects(const sf::RectangleShape& other) const;
+
+private:
+    sf::RectangleShape shape;
+};
+
+// 扫掠检测的一次查询：包围盒 box 平移 delta
+struct SweepQuery {
+    sf::FloatRect box;
+    sf::Vector2f delta;
+};
+
+// 射线或扫掠检测的结果 (没有挡住时 t 为 1、point 为终点；扫掠时 point 是包围盒左上角)
+struct RayHit {
+    float t = 1.f;              // 命中点在线段上的比例，起点就在障碍物里时为 0
+    sf::Vector2f point;
+    sf::Vector2f normal;        // 命中面的法线 (轴向单位向量，起点在障碍物里时为零向量)
+};
+
+// 障碍物区块：地图按 CHUNK_SIZE 分成区块，每个区块的障碍物由关卡种子和区块编号决定，
+// 玩家走近时才生成，走远后卸载 (再走回来时重新生成，结果相同)。
+// 障碍物不跨区块，区块内再按 CELL_SIZE 分格，碰撞查询只检查包围盒覆盖到的格子。
+// 只有中心区块周围 ACTIVE_RADIUS 圈内的区块参与查询，查询结果只取决于中心区块，与加载的先后无关
+class ObstacleGrid {
+public:
+    static const int CELL_SIZE = 64;
+    static const int CHUNK_SIZE = 256;                      // 必须是 CELL_SIZE 的整数倍
+    static const int CHUNK_CELLS = CHUNK_SIZE / CELL_SIZE;  // 每个区块每行的格子数
+    static const int ACTIVE_RADIUS = 2;
+    static const int EVICT_RADIUS = 3;                      // 超过这么多圈才卸载，在区块边界来回走动时不用反复生成
+
+    ObstacleGrid();
+
+    // 开始新的一关：卸载所有区块，之后的区块按关卡和种子生成
+    void reset(int level, uint64_t seed);
+    // 卸载所有区块
+    void clear();
+
+    // center 所在的区块变化时加载周围的区块、卸载远处的区块，返回中心区块是否变化
+    bool streamAround(const sf::Vector2f& center);
+
+    // 中心区块周围 radius 圈区块覆盖的范围 (夹在地图内)
+    sf::FloatRect getChunkArea(int radius) const;
+
+    // 包围盒是否与任何障碍物相交
+    bool intersects(const sf::FloatRect& box) const;
+
+    // 把与区域相交的障碍物包围盒写入 out (每个障碍物只写一次，最多 maxCount 个)，
+    // 返回相交的障碍物总数；超过 maxCount 时调用者应改用 intersects 逐个查询
+    size_t collect(const sf::FloatRect& area, sf::FloatRect* out, size_t maxCount) const;
+    // 把与区域相交的障碍物包围盒全部追加到 out
+    void query(const sf::FloatRect& area, std::vector<sf::FloatRect>& out) const;
+
+    // 包围盒沿长路径平移 delta 时第一次碰到障碍物的位置 (视线检测)：沿包围盒四个角在网格上各做一次 DDA，
+    // 经过的格子里的障碍物按包围盒的尺寸扩大后求交，命中点在当前格子以内就停止，代价与路径长度成正比。
+    // 结果与 sweep 相同。只读，可以在多个线程同时调用
+    bool castBox(const sf::FloatRect& box, const sf::Vector2f& delta, RayHit* hit = nullptr) const;
+    // 批量 castBox：hits[i] 对应 casts[i]，返回碰到障碍物的数量
+    size_t castBox(const SweepQuery* casts, size_t count, RayHit* hits) const;
+
+    // 包围盒平移 delta 的途中是否碰到障碍物 (连续碰撞，快速移动的物体不会穿过薄障碍物)。
+    // 碰到时 hit 为第一次接触的时刻和位置，接触时两个包围盒只是贴边，不相交；起点就相交时 t 为 0。
+    // 一次取出扫过的范围覆盖的所有格子，适合每帧的短位移；长路径用 castBox
+    bool sweep(const sf::FloatRect& box, const sf::Vector2f& delta, RayHit* hit = nullptr) const;
+
+    // 把与区域相交的障碍物追加到图形批次 (只画视野内的)
+    void appendTo(ShapeBatch& batch, const sf::FloatRect& area) const;
+
+    uint64_t getSeed() const { return seed; }
+    size_t size() const { return obstacleCount; }          // 已加载的障碍物数量
+    size_t getLoadedChunkCount() const { return loadedChunks; }
+
+private:
+    struct Chunk {
+        bool loaded = false;
+        std::vector<Obstacle> obstacles;
+        std::vector<sf::FloatRect> bounds;    // 缓存包围盒，避免每次查询都重新计算变换
+        std::vector<std::vector<int>> cells;  // 每个格子内的障碍物下标 (卸载时释放)
+    };
+
+    std::vector<Chunk> chunks;   // 每个区块一项，没有加载的区块不占障碍物内存
+    int chunkCols;
+    int chunkRows;
+    int level;
+    uint64_t seed;
+    int centerX;                 // 中心区块，-1 表示还没有加载任何区块
+    int centerY;
+    size_t obstacleCount;
+    size_t loadedChunks;
+
+    const Chunk* activeChunk(int chunkX, int chunkY) const;
+    void loadChunk(int chunkX, int chunkY);
+    void unloadChunk(int chunkX, int chunkY);
+    void addToChunk(Chunk& chunk, int chunkX, int chunkY, const Obstacle& obstacle);
+    bool chunkIntersects(const Chunk& chunk, int chunkX, int chunkY, const sf::FloatRect& box) const;
+    void castCorner(const sf::Vector2f& corner, const sf::FloatRect& box, const sf::Vector2f& delta, RayHit& best, bool& blocked) const;
+
+    // 计算包围盒覆盖的区块范围 (越界部分夹到地图边缘的区块)
+    void chunkRange(const sf::FloatRect& box, int& x0, int& y0, int& x1, int& y1) const;
+    // 计算包围盒在某个区块内覆盖的格子范围 (区块内的格子坐标，越界部分夹到区块边缘)
+    void cellRange(const sf::FloatRect& box, int chunkX, int chunkY, int& x0, int& y0, int& x1, int& y1) const;
+};
+
+// 出生点采样：按 STEP 间隔预先列出区域内所有放得下指定大小物体的位置，
+// 每次抽样只需要一个随机数，地图再挤也不会反复重试
+class SpawnSampler {
+public:
+    static const int STEP = 10;
+
+    void build(const ObstacleGrid& obstacles, const sf::FloatRect& area, const sf::Vector2f& size);
+
+    // 随机取一个空位 (左上角)，没有空位时返回 false
+    bool sample(Rng& rng, sf::Vector2f& position) const;
+
+    size_t size() const { return freePositions.size(); }
+
+private:
+    std::vector<sf::Vector2f> freePositions;
+};
+
+// 每个障碍物最多尝试摆放的次数，超过后放弃这个障碍物 (区块太挤时实际数量会少一些)；
+// 连续放弃 MAX_FAILED_PLACEMENTS 个说明区块已经放满，剩下的不再尝试
+const int MAX_PLACEMENT_ATTEMPTS = 64;
+const int MAX_FAILED_PLACEMENTS = 8;
+
+// 检查是否与任何障碍物碰撞
+bool checkObstacleCollision(const sf::FloatRect& bounds, const ObstacleGrid& obstacles);
+bool checkObstacleCollision(const sf::RectangleShape& object, const ObstacleGrid& obstacles);
+
+#endif // OBSTACLE_H
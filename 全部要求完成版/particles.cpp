@@ -0,0 +1,150 @@
+#include "particles.h"
+#include "jobs.h"
+
+ParticlePool::ParticlePool(size_t capacity) : maxParticles(capacity), wrap(false) {
+    x.reserve(capacity);
+    y.reserve(capacity);
+    vx.reserve(capacity);
+    vy.reserve(capacity);
+    drag.reserve(capacity);
+    life.reserve(capacity);
+    invMaxLife.reserve(capacity);
+    radius.reserve(capacity);
+    color.reserve(capacity);
+}
+
+void ParticlePool::emit(const sf::Vector2f& position, const sf::Vector2f& velocity, const sf::Color& particleColor,
+    float lifetime, float particleRadius, float particleDrag) {
+    if (full() || lifetime <= 0.f) {
+        return;
+    }
+    x.push_back(position.x);
+    y.push_back(position.y);
+    vx.push_back(velocity.x);
+    vy.push_back(velocity.y);
+    drag.push_back(particleDrag);
+    life.push_back(lifetime);
+    invMaxLife.push_back(1.f / lifetime);
+    radius.push_back(particleRadius);
+    color.push_back(particleColor);
+}
+
+void ParticlePool::update() {
+    // 每个粒子只和自己有关，分块并行
+    JobSystem::instance().parallelFor(size(), UPDATE_GRAIN, [this](size_t begin, size_t end) {
+        integrate(begin, end);
+    });
+    removeDead();
+}
+
+void ParticlePool::updateSerial() {
+    integrate(0, size());
+    removeDead();
+}
+
+// 推进 [begin, end) 内的粒子一帧。各列分开处理，编译器可以向量化
+void ParticlePool::integrate(size_t begin, size_t end) {
+    float* px = x.data();
+    float* py = y.data();
+    float* pvx = vx.data();
+    float* pvy = vy.data();
+    float* plife = life.data();
+    const float* pdrag = drag.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        px[i] += pvx[i];
+        py[i] += pvy[i];
+    }
+    for (size_t i = begin; i < end; ++i) {
+        pvx[i] *= pdrag[i];
+        pvy[i] *= pdrag[i];
+    }
+    for (size_t i = begin; i < end; ++i) {
+        plife[i] -= 1.f;
+    }
+
+    if (wrap) {
+        float right = wrapArea.left + wrapArea.width;
+        float bottom = wrapArea.top + wrapArea.height;
+        for (size_t i = begin; i < end; ++i) {
+            if (px[i] < wrapArea.left) px[i] = right;
+            if (px[i] > right) px[i] = wrapArea.left;
+            if (py[i] < wrapArea.top) py[i] = bottom;
+            if (py[i] > bottom) py[i] = wrapArea.top;
+        }
+    }
+}
+
+// 从后往前交换移除，换过来的粒子都已检查过
+void ParticlePool::removeDead() {
+    for (size_t i = size(); i-- > 0;) {
+        if (life[i] <= 0.f) {
+            removeSwap(i);
+        }
+    }
+}
+
+void ParticlePool::clear() {
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    drag.clear();
+    life.clear();
+    invMaxLife.clear();
+    radius.clear();
+    color.clear();
+}
+
+void ParticlePool::setWrapArea(const sf::FloatRect& area) {
+    wrap = true;
+    wrapArea = area;
+}
+
+void ParticlePool::appendTo(ShapeBatch& batch) const {
+    batch.reserve(batch.getVertexCount() + size() * 6);
+    for (size_t i = 0; i < size(); ++i) {
+        sf::Color c = color[i];
+        c.a = static_cast<sf::Uint8>(c.a * life[i] * invMaxLife[i]);
+        float r = radius[i];
+        batch.addRect(sf::FloatRect(x[i] - r, y[i] - r, r * 2.f, r * 2.f), c);
+    }
+}
+
+void ParticlePool::appendTo(ShapeBatch& batch, const sf::FloatRect& area) const {
+    const float right = area.left + area.width;
+    const float bottom = area.top + area.height;
+    for (size_t i = 0; i < size(); ++i) {
+        float r = radius[i];
+        if (x[i] + r < area.left || x[i] - r > right || y[i] + r < area.top || y[i] - r > bottom) {
+            continue;
+        }
+        sf::Color c = color[i];
+        c.a = static_cast<sf::Uint8>(c.a * life[i] * invMaxLife[i]);
+        batch.addRect(sf::FloatRect(x[i] - r, y[i] - r, r * 2.f, r * 2.f), c);
+    }
+}
+
+void ParticlePool::removeSwap(size_t i) {
+    size_t last = size() - 1;
+    if (i != last) {
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        drag[i] = drag[last];
+        life[i] = life[last];
+        invMaxLife[i] = invMaxLife[last];
+        radius[i] = radius[last];
+        color[i] = color[last];
+    }
+    x.pop_back();
+    y.pop_back();
+    vx.pop_back();
+    vy.pop_back();
+    drag.pop_back();
+    life.pop_back();
+    invMaxLife.pop_back();
+    radius.pop_back();
+    color.pop_back();
+}
@@ -0,0 +1,58 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <SFML/Graphics.hpp>
+#include "render.h"
+#include <vector>
+
+// 粒子池 (结构数组)：容量固定，满了之后新粒子直接丢弃。
+// 每次 update 推进一帧：移动、阻力衰减、寿命减一 (分块并行)，死亡的粒子用最后一个覆盖，
+// 所有粒子的透明度随剩余寿命线性降低
+class ParticlePool {
+public:
+    static const size_t UPDATE_GRAIN = 4096;   // 粒子多时分块并行更新，每个任务的粒子数
+
+    explicit ParticlePool(size_t capacity);
+
+    // position 为粒子中心，lifetime 以帧为单位，drag 为每帧速度的保留比例 (1 表示没有阻力)
+    void emit(const sf::Vector2f& position, const sf::Vector2f& velocity, const sf::Color& color,
+        float lifetime, float radius, float drag = 1.f);
+
+    void update();
+    // 与 update 相同，但在调用线程上逐个更新，不经过任务系统。
+    // 任务系统只允许模拟线程一个非工作线程提交任务，其他线程 (菜单背景) 用这个
+    void updateSerial();
+    void clear();
+
+    // 粒子离开这个区域时从另一边出现 (菜单背景用)
+    void setWrapArea(const sf::FloatRect& area);
+
+    // 每个粒子画成一个边长为直径的正方形
+    void appendTo(ShapeBatch& batch) const;
+    // 只追加与区域相交的粒子 (只画视野内的)
+    void appendTo(ShapeBatch& batch, const sf::FloatRect& area) const;
+
+    size_t size() const { return x.size(); }
+    size_t capacity() const { return maxParticles; }
+    bool full() const { return x.size() >= maxParticles; }
+
+private:
+    size_t maxParticles;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> drag;
+    std::vector<float> life;
+    std::vector<float> invMaxLife;     // 1 / 初始寿命，绘制时算透明度用
+    std::vector<float> radius;
+    std::vector<sf::Color> color;      // 初始颜色 (alpha 为满寿命时的透明度)
+    bool wrap;
+    sf::FloatRect wrapArea;
+
+    void integrate(size_t begin, size_t end);
+    void removeDead();
+    void removeSwap(size_t i);
+};
+
+#endif // PARTICLES_H
@@ -0,0 +1,176 @@
+#include "player.h"
+#include "savefile.h"
+#include <cstdlib>
+#include <cmath>
+
+// Player实现
+Player::Player() {
+    shape.setSize(sf::Vector2f(50, 50));
+    shape.setPosition(MAP_WIDTH / 2 - 25, MAP_HEIGHT / 2 - 25);  // 从地图中心出发
+    shape.setFillColor(sf::Color::Green);  // 设置玩家方块为绿色
+    health = PLAYER_MAX_HEALTH;
+    invincibilityFrames = 0;
+    shootCooldown = 0;
+}
+
+void Player::move(float dx, float dy, const ObstacleGrid& obstacles) {
+    sf::Vector2f newPos = shape.getPosition() + sf::Vector2f(dx, dy);
+
+    // 检查新位置是否与障碍物碰撞
+    if (!checkObstacleCollision(sf::FloatRect(newPos, shape.getSize()), obstacles)) {
+        if (newPos.x >= 0 && newPos.x + shape.getSize().x <= static_cast<float>(MAP_WIDTH)) {
+            shape.move(dx, 0);
+        }
+        if (newPos.y >= 0 && newPos.y + shape.getSize().y <= static_cast<float>(MAP_HEIGHT)) {
+            shape.move(0, dy);
+        }
+    }
+}
+
+void Player::reduceHealth() {
+    if (health > 0 && invincibilityFrames == 0) {
+        health--;
+        invincibilityFrames = 30;
+    }
+}
+
+void Player::updateInvincibility() {
+    if (invincibilityFrames > 0) {
+        invincibilityFrames--;
+    }
+}
+
+void Player::reset() {
+    shape.setPosition(MAP_WIDTH / 2 - 25, MAP_HEIGHT / 2 - 25);
+    health = PLAYER_MAX_HEALTH;
+    invincibilityFrames = 0;
+}
+
+bool Player::canShoot() const {
+    return shootCooldown == 0;
+}
+
+void Player::setShootCooldown() {
+    shootCooldown = 15;
+}
+
+void Player::updateShootCooldown() {
+    if (shootCooldown > 0) {
+        shootCooldown--;
+    }
+}
+
+void Player::writeState(ByteWriter& writer) const {
+    writer.writeFloat(shape.getPosition().x);
+    writer.writeFloat(shape.getPosition().y);
+    writer.writeInt(health);
+    writer.writeInt(invincibilityFrames);
+    writer.writeInt(shootCooldown);
+}
+
+bool Player::readState(ByteReader& reader) {
+    float x, y;
+    if (!reader.readFloat(x) || !reader.readFloat(y) || !reader.readInt(health) ||
+        !reader.readInt(invincibilityFrames) || !reader.readInt(shootCooldown)) {
+        return false;
+    }
+    shape.setPosition(x, y);
+    return true;
+}
+
+// MeleePlayer实现
+MeleePlayer::MeleePlayer() : Player() {
+    attackRange = 100.0f;  // 增加攻击范围
+    sweepAnimating = false;
+    sweepAngle = 0.f;
+}
+
+void MeleePlayer::setShootCooldown() {
+    shootCooldown = 20;
+}
+
+void MeleePlayer::startSweep() {
+    sweepAnimating = true;
+    sweepAngle = 0.f;
+}
+
+void MeleePlayer::updateSweep(ParticlePool& particles, Rng& rng) {
+    if (sweepAnimating) {
+        sweepAngle += 24.f;  // 保持原有的旋转速度
+
+        // 添加新的粒子
+        if (rng.nextInt(2) == 0) {  // 50%的概率生成新粒子
+            float currentAngle = (-90.f + sweepAngle) * 3.14159f / 180.f;
+            sf::Vector2f center = shape.getPosition() + shape.getSize() / 2.f;
+            float randRadius = attackRange * (0.6f + rng.nextInt(40) / 100.0f);  // 在60%-100%范围内随机
+
+            sf::Vector2f position = center + sf::Vector2f(
+                std::cos(currentAngle) * randRadius,
+                std::sin(currentAngle) * randRadius
+            );
+            // 浅蓝色、静止、持续10帧 (半径3像素，原点在(1.5, 1.5))
+            particles.emit(position + sf::Vector2f(1.5f, 1.5f), sf::Vector2f(0.f, 0.f), sf::Color(100, 200, 255, 255), 10.f, 3.f);
+        }
+
+        if (sweepAngle >= 360.f) {
+            sweepAnimating = false;
+            sweepAngle = 0.f;
+        }
+    }
+}
+
+void MeleePlayer::appendSweepEffect(ShapeBatch& batch) const {
+    if (sweepAnimating) {
+        // 绘制主要的扇形特效
+        float playerSize = shape.getSize().x;
+        float outerRadius = attackRange;
+        float innerRadius = playerSize * 0.8f;
+        sf::Vector2f center = shape.getPosition() + shape.getSize() / 2.f;
+
+        // 创建渐变效果的多层扇形，每层由若干四边形组成
+        for (float r = innerRadius; r <= outerRadius; r += (outerRadius - innerRadius) / 5.0f) {
+            int segments = 60;
+            float angleStep = sweepAngle / segments;
+            float alpha = 1.0f - ((r - innerRadius) / (outerRadius - innerRadius));
+            sf::Color ringColor(100, 200, 255, static_cast<sf::Uint8>(alpha * 128));  // 浅蓝色，最大透明度降低到128
+
+            sf::Vector2f prevOuter, prevInner;
+            for (int i = 0; i <= segments; ++i) {
+                float angle = -90.f + i * angleStep;
+                float rad = angle * 3.14159f / 180.f;
+                sf::Vector2f dir(std::cos(rad), std::sin(rad));
+                sf::Vector2f outer = center + dir * (r + 5);   // 外圈顶点
+                sf::Vector2f inner = center + dir * r;         // 内圈顶点
+                if (i > 0) {
+                    batch.addQuad(prevOuter, outer, inner, prevInner, ringColor);
+                }
+                prevOuter = outer;
+                prevInner = inner;
+            }
+        }
+    }
+}
+
+void MeleePlayer::writeState(ByteWriter& writer) const {
+    Player::writeState(writer);
+    writer.writeU8(sweepAnimating ? 1 : 0);
+    writer.writeFloat(sweepAngle);
+}
+
+bool MeleePlayer::readState(ByteReader& reader) {
+    unsigned char animating;
+    if (!Player::readState(reader) || !reader.readU8(animating) || !reader.readFloat(sweepAngle)) {
+        return false;
+    }
+    sweepAnimating = animating != 0;
+    return true;
+}
+
+// RangedPlayer实现
+RangedPlayer::RangedPlayer() : Player() {
+    bulletSpeed = 7.0f;
+}
+
+void RangedPlayer::setShootCooldown() {
+    shootCooldown = 20;
+}
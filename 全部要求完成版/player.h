@@ -0,0 +1,84 @@
+#ifndef PLAYER_H
+#define PLAYER_H
+
+#include "game.h"
+#include "obstacle.h"
+#include "render.h"
+#include "particles.h"
+#include <vector>
+
+class ByteWriter;
+class ByteReader;
+
+// 玩家基类 (只包含逻辑状态，贴图由绘制端根据位置摆放)
+class Player {
+public:
+    Player();
+    virtual ~Player() = default;
+
+    virtual void move(float dx, float dy, const ObstacleGrid& obstacles);
+
+    sf::RectangleShape getShape() const { return shape; }
+    sf::Vector2f getPosition() const { return shape.getPosition(); }
+    sf::Vector2f getCenter() const { return shape.getPosition() + shape.getSize() / 2.f; }
+    sf::FloatRect getBounds() const { return sf::FloatRect(shape.getPosition(), shape.getSize()); }
+    int getHealth() const { return health; }
+
+    void reduceHealth();
+    void updateInvincibility();
+    virtual void reset();
+
+    virtual bool canShoot() const;
+    virtual void setShootCooldown();
+    virtual void updateShootCooldown();
+
+    void setHealth(int newHealth) { health = newHealth; }
+
+    // 存档：位置、生命、无敌帧和射击冷却 (子类追加自己的状态)
+    virtual void writeState(ByteWriter& writer) const;
+    virtual bool readState(ByteReader& reader);
+
+protected:
+    sf::RectangleShape shape;
+    int health;
+    int invincibilityFrames;
+    int shootCooldown;
+};
+
+// 近战玩家类
+class MeleePlayer : public Player {
+public:
+    MeleePlayer();
+
+    float getAttackRange() const { return attackRange; }
+    void setShootCooldown() override;
+
+    void startSweep();
+    void updateSweep(ParticlePool& particles, Rng& rng);   // 粒子发射到特效粒子池，使用特效随机数流
+    void appendSweepEffect(ShapeBatch& batch) const;
+
+    bool isSweeping() const { return sweepAnimating; }
+    float getSweepAngle() const { return sweepAngle; }
+
+    void writeState(ByteWriter& writer) const override;
+    bool readState(ByteReader& reader) override;
+
+private:
+    float attackRange;
+    bool sweepAnimating;
+    float sweepAngle;
+};
+
+// 远程玩家类
+class RangedPlayer : public Player {
+public:
+    RangedPlayer();
+
+    float getBulletSpeed() const { return bulletSpeed; }
+    void setShootCooldown() override;
+
+private:
+    float bulletSpeed;
+};
+
+#endif // PLAYER_H
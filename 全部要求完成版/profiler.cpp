@@ -0,0 +1,189 @@
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+Profiler::Profiler() : enabled(false), history(HISTORY_FRAMES), nextFrame(0), frameCount(0), frameStart(0) {
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::now() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    // 加1保证有效的时间戳不为0 (ProfileZone 用0表示关闭)
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count()) + 1;
+}
+
+// 每个线程第一次记录时分配一个从0开始的编号
+int Profiler::threadIndex() {
+    static std::atomic<int> nextIndex(0);
+    thread_local int index = nextIndex++;
+    return index;
+}
+
+void Profiler::setEnabled(bool on) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (on && !enabled) {
+        current.clear();
+        frameStart = now();
+    }
+    enabled = on;
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end) {
+    int thread = threadIndex();
+    std::lock_guard<std::mutex> lock(mutex);
+    current.push_back(Event{ name, start, end, thread });
+}
+
+void Profiler::endFrame() {
+    if (!isEnabled()) {
+        return;
+    }
+    uint64_t end = now();
+    int thread = threadIndex();
+    std::lock_guard<std::mutex> lock(mutex);
+    Frame& frame = history[nextFrame];
+    frame.start = frameStart;
+    frame.end = end;
+    frame.thread = thread;
+    frame.events.swap(current);
+    current.clear();   // 复用被覆盖的旧帧的内存
+    nextFrame = (nextFrame + 1) % HISTORY_FRAMES;
+    size_t historyFrames = HISTORY_FRAMES;
+    frameCount = std::min(frameCount + 1, historyFrames);
+    frameStart = end;
+}
+
+// 排好序的数据中第 p 百分位的值
+static float percentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty()) {
+        return 0.f;
+    }
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+    return sorted[index];
+}
+
+static Profiler::ZoneStats makeStats(const char* name, std::vector<float>& samples) {
+    Profiler::ZoneStats stats;
+    stats.name = name;
+    std::sort(samples.begin(), samples.end());
+    float sum = 0.f;
+    for (float sample : samples) {
+        sum += sample;
+    }
+    stats.average = samples.empty() ? 0.f : sum / samples.size();
+    stats.p50 = percentile(samples, 0.5f);
+    stats.p95 = percentile(samples, 0.95f);
+    stats.max = samples.empty() ? 0.f : samples.back();
+    return stats;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // 每帧每个区间名的耗时之和 (没有出现的帧算0)，从旧到新
+    std::vector<const char*> names;
+    std::vector<std::vector<float>> samples;
+    std::vector<float> frameSamples;
+    size_t first = (nextFrame + HISTORY_FRAMES - frameCount) % HISTORY_FRAMES;
+    for (size_t n = 0; n < frameCount; ++n) {
+        const Frame& frame = history[(first + n) % HISTORY_FRAMES];
+        frameSamples.push_back((frame.end - frame.start) / 1e6f);
+        for (auto& zone : samples) {
+            zone.push_back(0.f);
+        }
+        for (const Event& event : frame.events) {
+            size_t zone = 0;
+            while (zone < names.size() && std::strcmp(names[zone], event.name) != 0) {
+                zone++;
+            }
+            if (zone == names.size()) {
+                names.push_back(event.name);
+                samples.push_back(std::vector<float>(n + 1, 0.f));
+            }
+            samples[zone].back() += (event.end - event.start) / 1e6f;
+        }
+    }
+
+    std::vector<ZoneStats> stats;
+    stats.push_back(makeStats("frame", frameSamples));
+    for (size_t zone = 0; zone < names.size(); ++zone) {
+        stats.push_back(makeStats(names[zone], samples[zone]));
+    }
+    return stats;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file << "{\"traceEvents\":[\n";
+    bool firstEvent = true;
+    size_t first = (nextFrame + HISTORY_FRAMES - frameCount) % HISTORY_FRAMES;
+    file << std::fixed << std::setprecision(3);
+    for (size_t n = 0; n < frameCount; ++n) {
+        const Frame& frame = history[(first + n) % HISTORY_FRAMES];
+        // 整帧作为主线程上最外层的区间，时间单位为微秒
+        file << (firstEvent ? "" : ",\n") << "{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":" << frame.thread << ",\"ts\":"
+            << frame.start / 1000.0 << ",\"dur\":" << (frame.end - frame.start) / 1000.0 << "}";
+        firstEvent = false;
+        for (const Event& event : frame.events) {
+            file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+void drawProfilerOverlay(sf::RenderTarget& target, const sf::Font& font) {
+    const float lineHeight = 16.f;
+    const float columnX[5] = { 10.f, 150.f, 210.f, 270.f, 330.f };
+    const char* headers[5] = { "zone (ms)", "avg", "p50", "p95", "max" };
+
+    std::vector<Profiler::ZoneStats> stats = Profiler::instance().getStats();
+
+    sf::RectangleShape background(sf::Vector2f(380.f, lineHeight * (stats.size() + 1) + 10.f));
+    background.setPosition(5.f, 5.f);
+    background.setFillColor(sf::Color(0, 0, 0, 180));
+    target.draw(background);
+
+    sf::Text text;
+    text.setFont(font);
+    text.setCharacterSize(13);
+    for (int column = 0; column < 5; ++column) {
+        text.setFillColor(sf::Color(180, 180, 180));
+        text.setString(headers[column]);
+        text.setPosition(columnX[column], 8.f);
+        target.draw(text);
+    }
+
+    text.setFillColor(sf::Color::White);
+    for (size_t row = 0; row < stats.size(); ++row) {
+        const Profiler::ZoneStats& zone = stats[row];
+        float values[4] = { zone.average, zone.p50, zone.p95, zone.max };
+        float y = 8.f + lineHeight * (row + 1);
+
+        text.setString(zone.name);
+        text.setPosition(columnX[0], y);
+        target.draw(text);
+        for (int column = 0; column < 4; ++column) {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(2) << values[column];
+            text.setString(ss.str());
+            text.setPosition(columnX[column + 1], y);
+            target.draw(text);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 帧耗时分析：用 PROFILE_ZONE 标记一段代码，离开作用域时记录一个区间 (可以在任何线程使用)。
+// 主线程每帧结束时调用 endFrame，最近 HISTORY_FRAMES 帧的区间保存在环形缓冲里，
+// 用于屏幕上的统计 (每段的平均、中位数、95% 和最大耗时) 和导出 Chrome trace。
+// 默认关闭，关闭时每个标记只读一次开关
+class Profiler {
+public:
+    static const size_t HISTORY_FRAMES = 240;
+
+    struct ZoneStats {
+        const char* name;
+        float average;   // 毫秒/帧
+        float p50;
+        float p95;
+        float max;
+    };
+
+    static Profiler& instance();
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // 记录一个区间 (纳秒，由 ProfileZone 调用)
+    void record(const char* name, uint64_t start, uint64_t end);
+    // 结束当前帧，把本帧的区间存入环形缓冲
+    void endFrame();
+
+    // 最近各帧的统计，按区间第一次出现的顺序，第一项是整帧耗时
+    std::vector<ZoneStats> getStats() const;
+    // 把环形缓冲里的所有区间写成 Chrome trace (chrome://tracing 或 Perfetto 打开)
+    bool exportChromeTrace(const std::string& path) const;
+
+    // 从程序启动开始的纳秒数
+    static uint64_t now();
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+        int thread;
+    };
+
+    struct Frame {
+        uint64_t start = 0;
+        uint64_t end = 0;
+        int thread = 0;   // 调用 endFrame 的线程
+        std::vector<Event> events;
+    };
+
+    std::atomic<bool> enabled;
+    mutable std::mutex mutex;
+    std::vector<Event> current;
+    std::vector<Frame> history;   // 环形缓冲
+    size_t nextFrame;
+    size_t frameCount;
+    uint64_t frameStart;
+
+    Profiler();
+    static int threadIndex();
+};
+
+// 作用域标记：构造时记下开始时间，析构时记录区间
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : name(name), start(Profiler::instance().isEnabled() ? Profiler::now() : 0) {}
+
+    ~ProfileZone() { stop(); }
+
+    // 提前结束区间 (区间不对应一个作用域时使用)
+    void stop() {
+        if (start != 0) {
+            Profiler::instance().record(name, start, Profiler::now());
+            start = 0;
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#ifdef NO_PROFILER
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#endif
+
+// 左上角的统计面板 (F3 打开)
+void drawProfilerOverlay(sf::RenderTarget& target, const sf::Font& font);
+
+#endif // PROFILER_H
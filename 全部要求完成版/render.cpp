@@ -0,0 +1,25 @@
+#include "render.h"
+
+void ShapeBatch::addRect(const sf::FloatRect& rect, const sf::Color& color) {
+    sf::Vector2f topLeft(rect.left, rect.top);
+    sf::Vector2f topRight(rect.left + rect.width, rect.top);
+    sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+    sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+    addQuad(topLeft, topRight, bottomRight, bottomLeft, color);
+}
+
+void ShapeBatch::addQuad(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c, const sf::Vector2f& d,
+    const sf::Color& color) {
+    vertices.emplace_back(a, color);
+    vertices.emplace_back(b, color);
+    vertices.emplace_back(c, color);
+    vertices.emplace_back(a, color);
+    vertices.emplace_back(c, color);
+    vertices.emplace_back(d, color);
+}
+
+void ShapeBatch::draw(sf::RenderTarget& target) const {
+    if (!vertices.empty()) {
+        target.draw(vertices.data(), vertices.size(), sf::Triangles);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// 图形批次：一帧内的矩形和扇形都拆成三角形追加到同一个顶点数组，
+// 绘制时一次提交，绘制调用次数与物体数量无关
+class ShapeBatch {
+public:
+    void clear() { vertices.clear(); }
+    void reserve(size_t vertexCount) { vertices.reserve(vertexCount); }
+
+    void addRect(const sf::FloatRect& rect, const sf::Color& color);
+    // 四个顶点按顺序围成的四边形
+    void addQuad(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c, const sf::Vector2f& d,
+        const sf::Color& color);
+
+    void draw(sf::RenderTarget& target) const;
+
+    size_t getVertexCount() const { return vertices.size(); }
+
+private:
+    std::vector<sf::Vertex> vertices;
+};
+
+#endif // RENDER_H
@@ -0,0 +1,223 @@
+#include "replay.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const char REPLAY_MAGIC[4] = { 'R', 'P', 'L', 'Y' };
+const uint32_t REPLAY_VERSION = 6;   // 2: 大地图；3: 怪物并行更新；4: 怪物错帧决策；5: 子弹扫掠碰撞；6: 远处的怪物降频时按原速推进 (旧录像的随机行为不同，无法重放)
+
+// 按键状态打包成一个字节
+enum InputBits : unsigned char {
+    INPUT_LEFT = 1,
+    INPUT_RIGHT = 2,
+    INPUT_UP = 4,
+    INPUT_DOWN = 8,
+    INPUT_ATTACK = 16
+};
+
+static void writeU32(std::ofstream& file, uint32_t value) {
+    unsigned char bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+    file.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+static void writeU64(std::ofstream& file, uint64_t value) {
+    writeU32(file, static_cast<uint32_t>(value));
+    writeU32(file, static_cast<uint32_t>(value >> 32));
+}
+
+static void writeFloat(std::ofstream& file, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(file, bits);
+}
+
+static bool readU32(std::ifstream& file, uint32_t& value) {
+    unsigned char bytes[4];
+    if (!file.read(reinterpret_cast<char*>(bytes), 4)) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+    }
+    return true;
+}
+
+static bool readU64(std::ifstream& file, uint64_t& value) {
+    uint32_t low, high;
+    if (!readU32(file, low) || !readU32(file, high)) {
+        return false;
+    }
+    value = static_cast<uint64_t>(high) << 32 | low;
+    return true;
+}
+
+static bool readFloat(std::ifstream& file, float& value) {
+    uint32_t bits;
+    if (!readU32(file, bits)) {
+        return false;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+static bool readInt(std::ifstream& file, int& value) {
+    uint32_t bits;
+    if (!readU32(file, bits)) {
+        return false;
+    }
+    value = static_cast<int>(bits);
+    return true;
+}
+
+bool saveReplay(const Replay& replay, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.write(REPLAY_MAGIC, 4);
+    writeU32(file, REPLAY_VERSION);
+    writeU64(file, replay.seed);
+    writeU32(file, static_cast<uint32_t>(replay.playerType));
+    writeU32(file, static_cast<uint32_t>(replay.level));
+    writeU32(file, static_cast<uint32_t>(replay.score));
+    writeU32(file, static_cast<uint32_t>(replay.health));
+    writeU32(file, static_cast<uint32_t>(replay.size()));
+
+    for (size_t i = 0; i < replay.size(); ++i) {
+        const InputFrame& input = replay.inputs[i];
+        unsigned char bits = 0;
+        if (input.left) bits |= INPUT_LEFT;
+        if (input.right) bits |= INPUT_RIGHT;
+        if (input.up) bits |= INPUT_UP;
+        if (input.down) bits |= INPUT_DOWN;
+        if (input.attack) bits |= INPUT_ATTACK;
+        file.put(static_cast<char>(bits));
+
+        if (input.attack) {
+            writeFloat(file, input.target.x);
+            writeFloat(file, input.target.y);
+        }
+        writeU32(file, replay.hashes[i]);
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool loadReplay(Replay& replay, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version, count;
+    if (!file.read(magic, 4) || std::memcmp(magic, REPLAY_MAGIC, 4) != 0 ||
+        !readU32(file, version) || version != REPLAY_VERSION) {
+        return false;
+    }
+
+    Replay loaded;
+    if (!readU64(file, loaded.seed) || !readInt(file, loaded.playerType) || !readInt(file, loaded.level) ||
+        !readInt(file, loaded.score) || !readInt(file, loaded.health) || !readU32(file, count)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        int bits = file.get();
+        if (bits == EOF) {
+            return false;
+        }
+
+        InputFrame input;
+        input.left = (bits & INPUT_LEFT) != 0;
+        input.right = (bits & INPUT_RIGHT) != 0;
+        input.up = (bits & INPUT_UP) != 0;
+        input.down = (bits & INPUT_DOWN) != 0;
+        input.attack = (bits & INPUT_ATTACK) != 0;
+        if (input.attack && (!readFloat(file, input.target.x) || !readFloat(file, input.target.y))) {
+            return false;
+        }
+        uint32_t hash;
+        if (!readU32(file, hash)) {
+            return false;
+        }
+        loaded.inputs.push_back(input);
+        loaded.hashes.push_back(hash);
+    }
+
+    replay = std::move(loaded);
+    return true;
+}
+
+void ReplayRecorder::begin(const World& world) {
+    replay = Replay();
+    replay.seed = world.getSeed();
+    replay.playerType = world.getPlayerType();
+    replay.level = world.getLevel();
+    replay.score = world.getScore();
+    replay.health = world.getPlayer().getHealth();
+    recording = true;
+}
+
+void ReplayRecorder::record(const InputFrame& input, const World& world) {
+    if (!recording) {
+        return;
+    }
+    replay.inputs.push_back(input);
+    replay.hashes.push_back(world.stateHash());
+}
+
+void ReplayRecorder::finish(const std::string& path) {
+    if (!recording) {
+        return;
+    }
+    recording = false;
+    if (!saveReplay(replay, path)) {
+        std::cerr << "Error: Failed to write replay " << path << std::endl;
+    }
+}
+
+bool ReplayRecorder::take(Replay& out) {
+    if (!recording) {
+        return false;
+    }
+    recording = false;
+    out = std::move(replay);
+    replay = Replay();
+    return true;
+}
+
+void ReplayPlayer::start(const Replay& source, World& world) {
+    replay = &source;
+    cursor = 0;
+    desyncTick = -1;
+    world.start(source.playerType, source.level, source.score, source.health, source.seed);
+}
+
+bool ReplayPlayer::step(World& world) {
+    if (isFinished()) {
+        return false;
+    }
+    if (world.getStatus() == WorldStatus::LEVEL_COMPLETE) {
+        world.nextLevel();
+    }
+    if (!world.isRunning()) {
+        return false;
+    }
+
+    world.step(replay->inputs[cursor]);
+    if (desyncTick < 0 && world.stateHash() != replay->hashes[cursor]) {
+        desyncTick = static_cast<long long>(cursor);
+    }
+    cursor++;
+    return true;
+}
+
+bool ReplayPlayer::isFinished() const {
+    return replay == nullptr || cursor >= replay->size();
+}
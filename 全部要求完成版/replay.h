@@ -0,0 +1,62 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "world.h"
+#include <string>
+#include <vector>
+
+// 一局录像：开局参数 + 每个逻辑帧的输入和该帧结束后的状态哈希
+struct Replay {
+    uint64_t seed = 0;
+    int playerType = 0;
+    int level = 1;
+    int score = 0;
+    int health = PLAYER_MAX_HEALTH;
+    std::vector<InputFrame> inputs;
+    std::vector<uint32_t> hashes;
+
+    size_t size() const { return inputs.size(); }
+};
+
+// 录像文件读写 (二进制，小端)。每帧1字节按键状态，点击帧额外8字节点击位置，再加4字节哈希
+bool saveReplay(const Replay& replay, const std::string& path);
+bool loadReplay(Replay& replay, const std::string& path);
+
+// 录像器：World::start 之后 begin，每次 World::step 之后 record
+class ReplayRecorder {
+public:
+    void begin(const World& world);
+    void record(const InputFrame& input, const World& world);
+    // 结束录像并写入文件，没有在录像时什么都不做
+    void finish(const std::string& path);
+    // 结束录像并把录像移到 out (之后在不持有世界锁时写文件)，没有在录像时返回false
+    bool take(Replay& out);
+
+    bool isRecording() const { return recording; }
+    const Replay& getReplay() const { return replay; }
+
+private:
+    Replay replay;
+    bool recording = false;
+};
+
+// 重放器：用录像的种子开局，按录像输入逐帧推进并比较哈希。
+// 录像里的关卡结束后自动进入下一关 (该状态下玩家唯一能做的就是点继续)
+class ReplayPlayer {
+public:
+    void start(const Replay& replay, World& world);
+    // 推进一个逻辑帧，录像放完或游戏结束时返回 false
+    bool step(World& world);
+
+    bool isFinished() const;
+    size_t getCursor() const { return cursor; }
+    // 第一次哈希不一致的帧，没有不同步返回 -1
+    long long getDesyncTick() const { return desyncTick; }
+
+private:
+    const Replay* replay = nullptr;
+    size_t cursor = 0;
+    long long desyncTick = -1;
+};
+
+#endif // REPLAY_H
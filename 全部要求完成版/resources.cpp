@@ -0,0 +1,188 @@
+#include "resources.h"
+#include "profiler.h"
+#include <algorithm>
+#include <iostream>
+
+ResourceCache::ResourceCache() : atlasBuilt(false), nextJob(0), finishedJobs(0), decodedSprites(0) {
+}
+
+ResourceCache::~ResourceCache() {
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ResourceCache::requestTexture(const std::string& path) {
+    if (textures.count(path) > 0) {
+        return;
+    }
+    textures[path];
+    jobs.push_back(LoadJob{ path, -1, sf::Image(), false });
+}
+
+SpriteHandle ResourceCache::addSprite(const std::string& name, const std::string& path) {
+    SpriteHandle handle = findSprite(name);
+    if (handle.isValid()) {
+        return handle;
+    }
+
+    handle.index = static_cast<int>(sprites.size());
+    sprites.push_back(AtlasEntry{ name, sf::Image(), sf::IntRect() });
+    jobs.push_back(LoadJob{ path, handle.index, sf::Image(), false });
+    return handle;
+}
+
+void ResourceCache::startLoading() {
+    if (!workers.empty() || jobs.empty()) {
+        return;
+    }
+    unsigned maxThreads = MAX_LOADER_THREADS;
+    unsigned threadCount = std::max(1u, std::min(std::thread::hardware_concurrency(), maxThreads));
+    threadCount = std::min(threadCount, static_cast<unsigned>(jobs.size()));
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ResourceCache::decodeJobs, this);
+    }
+}
+
+// 工作线程：依次领取还没解码的图片
+void ResourceCache::decodeJobs() {
+    for (;;) {
+        size_t index = nextJob++;
+        if (index >= jobs.size()) {
+            return;
+        }
+        LoadJob& job = jobs[index];
+        {
+            PROFILE_ZONE("decode image");
+            job.ok = job.image.loadFromFile(job.path);
+        }
+
+        std::lock_guard<std::mutex> lock(readyMutex);
+        readyJobs.push_back(index);
+    }
+}
+
+void ResourceCache::uploadPending(sf::Time budget) {
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        uploadQueue.insert(uploadQueue.end(), readyJobs.begin(), readyJobs.end());
+        readyJobs.clear();
+    }
+
+    PROFILE_ZONE("upload textures");
+    sf::Clock clock;
+    size_t next = 0;
+    while (next < uploadQueue.size() && (next == 0 || clock.getElapsedTime() < budget)) {
+        LoadJob& job = jobs[uploadQueue[next++]];
+        if (!job.ok) {
+            std::cerr << "Error: Failed to load image " << job.path << std::endl;
+        }
+        if (job.spriteIndex >= 0) {
+            // 小图先攒着，全部解码后一起打包
+            sprites[job.spriteIndex].image = job.image;
+            decodedSprites++;
+        }
+        else if (job.ok) {
+            textures[job.path].loadFromImage(job.image);
+        }
+        job.image = sf::Image();
+        finishedJobs++;
+    }
+    uploadQueue.erase(uploadQueue.begin(), uploadQueue.begin() + next);
+
+    if (!atlasBuilt && !sprites.empty() && decodedSprites == sprites.size() &&
+        (next == 0 || clock.getElapsedTime() < budget)) {
+        buildAtlas();
+    }
+
+    // 全部解码完成后回收工作线程
+    if (finishedJobs == jobs.size() && !workers.empty()) {
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+}
+
+float ResourceCache::getProgress() const {
+    // 贴图集的打包上传算作一项
+    size_t total = jobs.size() + (sprites.empty() ? 0 : 1);
+    size_t done = finishedJobs + (atlasBuilt ? 1 : 0);
+    return total == 0 ? 1.f : static_cast<float>(done) / total;
+}
+
+const sf::Texture& ResourceCache::getTexture(const std::string& path) const {
+    auto found = textures.find(path);
+    return found != textures.end() ? found->second : emptyTexture;
+}
+
+// 按高度从高到低一行一行摆放 (货架法)。贴图集宽度取能放下最宽图片的2的幂，至少256
+void ResourceCache::buildAtlas() {
+    atlasBuilt = true;
+
+    std::vector<int> order(sprites.size());
+    unsigned width = 256;
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        order[i] = static_cast<int>(i);
+        while (width < sprites[i].image.getSize().x + ATLAS_PADDING) {
+            width *= 2;
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return sprites[a].image.getSize().y > sprites[b].image.getSize().y;
+    });
+
+    unsigned x = 0, y = 0, shelfHeight = 0;
+    for (int index : order) {
+        sf::Vector2u size = sprites[index].image.getSize();
+        if (x + size.x > width) {
+            x = 0;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        sprites[index].rect = sf::IntRect(x, y, size.x, size.y);
+        x += size.x + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, size.y);
+    }
+    unsigned height = std::max(y + shelfHeight, 1u);
+    if (height > sf::Texture::getMaximumSize()) {
+        std::cerr << "Error: Sprite atlas is too large" << std::endl;
+        for (AtlasEntry& entry : sprites) {
+            entry.rect = sf::IntRect();
+        }
+        return;
+    }
+
+    sf::Image packed;
+    packed.create(width, height, sf::Color::Transparent);
+    for (AtlasEntry& entry : sprites) {
+        if (entry.rect.width > 0) {
+            packed.copy(entry.image, entry.rect.left, entry.rect.top);
+        }
+        entry.image = sf::Image();   // 已经复制进贴图集，释放解码出来的图片
+    }
+    atlas.loadFromImage(packed);
+}
+
+SpriteHandle ResourceCache::findSprite(const std::string& name) const {
+    SpriteHandle handle;
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        if (sprites[i].name == name) {
+            handle.index = static_cast<int>(i);
+            break;
+        }
+    }
+    return handle;
+}
+
+sf::IntRect ResourceCache::getRect(SpriteHandle handle) const {
+    if (!handle.isValid()) {
+        return sf::IntRect();
+    }
+    return sprites[handle.index].rect;
+}
+
+void ResourceCache::applySprite(sf::Sprite& sprite, SpriteHandle handle) const {
+    sprite.setTexture(atlas);
+    sprite.setTextureRect(getRect(handle));
+}
@@ -0,0 +1,95 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 贴图集中一块区域的句柄 (只是下标，可以随意复制)
+struct SpriteHandle {
+    int index = -1;
+
+    bool isValid() const { return index >= 0; }
+};
+
+// 资源缓存：每个图片文件只解码一次。
+// 整屏的背景图各自作为一张贴图缓存；角色等小图打包进同一张贴图集，
+// 按名字查找区域，用同一张贴图绘制时不需要切换贴图。
+// 图片在工作线程解码，主线程每帧在时间预算内上传成贴图 (贴图只能在主线程创建)
+class ResourceCache {
+public:
+    static const unsigned ATLAS_PADDING = 1;   // 区域之间留空，避免缩放时采样到相邻的图
+    static const unsigned MAX_LOADER_THREADS = 4;
+
+    ResourceCache();
+    // 等工作线程解码完当前的图片再退出
+    ~ResourceCache();
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    // 登记一张整张加载的贴图 (同一路径只登记一次)
+    void requestTexture(const std::string& path);
+    // 登记一张要打包进贴图集的小图 (同名只登记一次)，贴图集建好之后区域才有效
+    SpriteHandle addSprite(const std::string& name, const std::string& path);
+
+    // 开始在工作线程解码所有登记的图片
+    void startLoading();
+    // 主线程每帧调用：把解码好的图片上传成贴图，超过预算就留到下一帧 (每次至少上传一张)。
+    // 小图全部解码后打包上传贴图集
+    void uploadPending(sf::Time budget);
+
+    bool isLoaded() const { return finishedJobs == jobs.size() && (sprites.empty() || atlasBuilt); }
+    // 已完成的比例 (0 ~ 1)
+    float getProgress() const;
+
+    // 整张贴图，还没加载完或加载失败时返回空贴图
+    const sf::Texture& getTexture(const std::string& path) const;
+
+    SpriteHandle findSprite(const std::string& name) const;
+    const sf::Texture& getAtlas() const { return atlas; }
+    sf::IntRect getRect(SpriteHandle handle) const;
+
+    // 让精灵显示贴图集中的这块区域
+    void applySprite(sf::Sprite& sprite, SpriteHandle handle) const;
+
+private:
+    struct AtlasEntry {
+        std::string name;
+        sf::Image image;
+        sf::IntRect rect;
+    };
+
+    // 一张要解码的图片，spriteIndex 为 -1 表示整张贴图
+    struct LoadJob {
+        std::string path;
+        int spriteIndex;
+        sf::Image image;
+        bool ok;
+    };
+
+    std::map<std::string, sf::Texture> textures;
+    sf::Texture emptyTexture;
+    std::vector<AtlasEntry> sprites;
+    sf::Texture atlas;
+    bool atlasBuilt;
+
+    std::deque<LoadJob> jobs;            // 解码中不增删，工作线程只写自己领到的那一项
+    std::atomic<size_t> nextJob;
+    std::mutex readyMutex;
+    std::vector<size_t> readyJobs;       // 已解码、等待主线程上传
+    std::vector<size_t> uploadQueue;
+    size_t finishedJobs;
+    size_t decodedSprites;
+    std::vector<std::thread> workers;
+
+    void decodeJobs();
+    void buildAtlas();
+};
+
+#endif // RESOURCES_H
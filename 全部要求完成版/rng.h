@@ -0,0 +1,87 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// 随机数流 (xoshiro128**)：状态只有16字节，没有锁，同一种子得到同一序列。
+// 每个子系统各用一个流，互不干扰
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    // 用 splitmix64 把64位种子展开成4个状态字 (保证不全为0)
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; i += 2) {
+            uint64_t z = splitMix64(seed);
+            s[i] = static_cast<uint32_t>(z);
+            s[i + 1] = static_cast<uint32_t>(z >> 32);
+        }
+    }
+
+    uint32_t next() {
+        const uint32_t result = rotl(s[1] * 5, 7) * 9;
+        const uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // [0, bound) 内的整数，用乘法取高位代替取模 (代替 rand() % bound)
+    int nextInt(int bound) {
+        return static_cast<int>((static_cast<uint64_t>(next()) * static_cast<uint32_t>(bound)) >> 32);
+    }
+
+    // [0, 1) 内的浮点数
+    float nextFloat() {
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // 读取/恢复内部状态 (存档用)；全0状态无效，恢复时改为用0重新播种
+    void getState(uint32_t state[4]) const {
+        for (int i = 0; i < 4; ++i) {
+            state[i] = s[i];
+        }
+    }
+
+    void setState(const uint32_t state[4]) {
+        if ((state[0] | state[1] | state[2] | state[3]) == 0) {
+            reseed(0);
+            return;
+        }
+        for (int i = 0; i < 4; ++i) {
+            s[i] = state[i];
+        }
+    }
+
+    // 由主种子和流编号派生出子流的种子
+    static uint64_t deriveSeed(uint64_t seed, uint64_t stream) {
+        uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        return splitMix64(state);
+    }
+
+    // 无状态的随机整数：由种子和编号直接算出 [0, bound) 内的整数，与调用顺序无关 (并行更新时用)
+    static int hashInt(uint64_t seed, uint64_t index, int bound) {
+        uint32_t bits = static_cast<uint32_t>(deriveSeed(seed, index) >> 32);
+        return static_cast<int>((static_cast<uint64_t>(bits) * static_cast<uint32_t>(bound)) >> 32);
+    }
+
+private:
+    uint32_t s[4];
+
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    static uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+#endif // RNG_H
@@ -0,0 +1,330 @@
+#include "savefile.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// 文件头：4字节标识 + 版本号，之后是若干个块 (种类、长度、哈希、内容)
+const char SAVE_MAGIC[4] = { 'R', 'L', 'S', 'V' };
+const uint32_t SAVE_VERSION = 1;
+const size_t CHUNK_HEADER_SIZE = 12;
+
+// 旧格式存档是 GameSave 结构体 (4个 int 加一个 bool) 的内存内容
+const size_t LEGACY_SAVE_MIN_SIZE = 17;
+
+void ByteWriter::writeU32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        bytes.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+}
+
+void ByteWriter::writeU64(uint64_t value) {
+    writeU32(static_cast<uint32_t>(value));
+    writeU32(static_cast<uint32_t>(value >> 32));
+}
+
+void ByteWriter::writeFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(bits);
+}
+
+bool ByteReader::readU8(unsigned char& value) {
+    if (pos >= bytes.size()) {
+        pos = bytes.size() + 1;
+        return false;
+    }
+    value = bytes[pos++];
+    return true;
+}
+
+bool ByteReader::readU32(uint32_t& value) {
+    if (pos + 4 > bytes.size()) {
+        pos = bytes.size() + 1;
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(bytes[pos + i]) << (i * 8);
+    }
+    pos += 4;
+    return true;
+}
+
+bool ByteReader::readU64(uint64_t& value) {
+    uint32_t low, high;
+    if (!readU32(low) || !readU32(high)) {
+        return false;
+    }
+    value = static_cast<uint64_t>(high) << 32 | low;
+    return true;
+}
+
+bool ByteReader::readInt(int& value) {
+    uint32_t bits;
+    if (!readU32(bits)) {
+        return false;
+    }
+    value = static_cast<int>(bits);
+    return true;
+}
+
+bool ByteReader::readFloat(float& value) {
+    uint32_t bits;
+    if (!readU32(bits)) {
+        return false;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+const SaveChunk* WorldSnapshot::find(uint32_t id) const {
+    for (const SaveChunk& chunk : chunks) {
+        if (chunk.id == id) {
+            return &chunk;
+        }
+    }
+    return nullptr;
+}
+
+void WorldSnapshot::set(uint32_t id, const std::vector<unsigned char>& data) {
+    for (SaveChunk& chunk : chunks) {
+        if (chunk.id == id) {
+            chunk.data = data;
+            return;
+        }
+    }
+    chunks.push_back(SaveChunk{ id, data });
+}
+
+// FNV-1a 哈希，检查块是否写完整、内容是否变化
+static uint32_t chunkHash(const std::vector<unsigned char>& data) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char byte : data) {
+        hash ^= byte;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void putU32(std::vector<unsigned char>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+}
+
+static uint32_t getU32(const unsigned char* bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+    }
+    return value;
+}
+
+static void appendChunk(std::vector<unsigned char>& out, const SaveChunk& chunk) {
+    putU32(out, chunk.id);
+    putU32(out, static_cast<uint32_t>(chunk.data.size()));
+    putU32(out, chunkHash(chunk.data));
+    out.insert(out.end(), chunk.data.begin(), chunk.data.end());
+}
+
+// 把字节写入文件并等待写到磁盘 (mode 为 "wb" 或 "ab")
+static bool writeFileSynced(const std::string& path, const std::vector<unsigned char>& bytes, const char* mode) {
+    FILE* file = std::fopen(path.c_str(), mode);
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    return std::fclose(file) == 0 && ok;
+}
+
+bool readSnapshotSummary(const WorldSnapshot& snapshot, SaveSummary& summary) {
+    const SaveChunk* meta = snapshot.find(CHUNK_META);
+    if (!meta) {
+        return false;
+    }
+    ByteReader reader(meta->data);
+    return reader.readInt(summary.playerType) && reader.readInt(summary.level) &&
+        reader.readInt(summary.score) && reader.readInt(summary.health);
+}
+
+// 从 pos 开始读出 [pos, end) 内的所有块，遇到写坏的块时停下，返回是否全部读完。
+// 块组里的块先读到临时快照，整组完整才放进 snapshot
+static bool readChunks(const std::vector<unsigned char>& bytes, size_t pos, size_t end, WorldSnapshot& snapshot) {
+    while (pos + CHUNK_HEADER_SIZE <= end) {
+        uint32_t id = getU32(&bytes[pos]);
+        uint32_t size = getU32(&bytes[pos + 4]);
+        uint32_t hash = getU32(&bytes[pos + 8]);
+        pos += CHUNK_HEADER_SIZE;
+        if (size > end - pos) {
+            return false;
+        }
+        std::vector<unsigned char> data(bytes.begin() + pos, bytes.begin() + pos + size);
+        if (chunkHash(data) != hash) {
+            return false;
+        }
+        if (id == CHUNK_GROUP) {
+            WorldSnapshot group;
+            if (!readChunks(bytes, pos, pos + size, group)) {
+                return false;
+            }
+            for (const SaveChunk& chunk : group.chunks) {
+                snapshot.set(chunk.id, chunk.data);
+            }
+        }
+        else {
+            snapshot.set(id, data);
+        }
+        pos += size;
+    }
+    return pos == end;
+}
+
+bool readSaveFile(const std::string& path, WorldSnapshot& snapshot, SaveSummary& summary) {
+    snapshot.clear();
+    summary = SaveSummary();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < 8 || std::memcmp(bytes.data(), SAVE_MAGIC, 4) != 0) {
+        if (bytes.size() < LEGACY_SAVE_MIN_SIZE) {
+            return false;
+        }
+        summary.exists = true;
+        summary.legacy = true;
+        summary.playerType = static_cast<int>(getU32(&bytes[0]));
+        summary.health = static_cast<int>(getU32(&bytes[4]));
+        summary.level = static_cast<int>(getU32(&bytes[8]));
+        summary.score = static_cast<int>(getU32(&bytes[12]));
+        return true;
+    }
+    if (getU32(&bytes[4]) != SAVE_VERSION) {
+        return false;
+    }
+
+    // 末尾写坏的部分直接忽略，前面完整的块照常使用
+    readChunks(bytes, 8, bytes.size(), snapshot);
+
+    if (!readSnapshotSummary(snapshot, summary)) {
+        snapshot.clear();
+        return false;
+    }
+    summary.exists = true;
+    return true;
+}
+
+bool writeSaveFile(const std::string& path, const WorldSnapshot& snapshot) {
+    std::vector<unsigned char> bytes(SAVE_MAGIC, SAVE_MAGIC + 4);
+    putU32(bytes, SAVE_VERSION);
+    for (const SaveChunk& chunk : snapshot.chunks) {
+        appendChunk(bytes, chunk);
+    }
+
+    std::string tempPath = path + ".tmp";
+    if (!writeFileSynced(tempPath, bytes, "wb")) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Windows 上目标文件存在时 rename 会失败，这时先删除原文件再改名
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SaveWriter::open(const std::string& filePath) {
+    path = filePath;
+    writtenHashes.clear();
+    fullSize = 0;
+    appendedSize = 0;
+}
+
+bool SaveWriter::writeFull(const WorldSnapshot& snapshot) {
+    if (path.empty() || !writeSaveFile(path, snapshot)) {
+        return false;
+    }
+    fullSize = 8;
+    for (const SaveChunk& chunk : snapshot.chunks) {
+        fullSize += CHUNK_HEADER_SIZE + chunk.data.size();
+    }
+    appendedSize = 0;
+    writtenHashes.clear();
+    rememberHashes(snapshot);
+    return true;
+}
+
+bool SaveWriter::writeDelta(const WorldSnapshot& snapshot) {
+    if (path.empty()) {
+        return false;
+    }
+    if (writtenHashes.empty()) {
+        return writeFull(snapshot);
+    }
+
+    SaveChunk group{ CHUNK_GROUP, std::vector<unsigned char>() };
+    for (const SaveChunk& chunk : snapshot.chunks) {
+        uint32_t hash = chunkHash(chunk.data);
+        bool changed = true;
+        for (const auto& written : writtenHashes) {
+            if (written.first == chunk.id) {
+                changed = written.second != hash;
+                break;
+            }
+        }
+        if (changed) {
+            appendChunk(group.data, chunk);
+        }
+    }
+    if (group.data.empty()) {
+        return true;
+    }
+    // 变化的块打包成一个块组，组的哈希覆盖全部内容，写到一半时整组都不生效
+    std::vector<unsigned char> bytes;
+    appendChunk(bytes, group);
+    if (appendedSize + bytes.size() > fullSize) {
+        return writeFull(snapshot);
+    }
+
+    if (!writeFileSynced(path, bytes, "ab")) {
+        // 追加失败时文件末尾可能有写了一半的块组，读取时会被忽略；下次改为完整写入
+        writtenHashes.clear();
+        return false;
+    }
+    appendedSize += bytes.size();
+    rememberHashes(snapshot);
+    return true;
+}
+
+void SaveWriter::rememberHashes(const WorldSnapshot& snapshot) {
+    for (const SaveChunk& chunk : snapshot.chunks) {
+        uint32_t hash = chunkHash(chunk.data);
+        bool found = false;
+        for (auto& written : writtenHashes) {
+            if (written.first == chunk.id) {
+                written.second = hash;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            writtenHashes.push_back(std::make_pair(chunk.id, hash));
+        }
+    }
+}
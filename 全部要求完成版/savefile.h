@@ -0,0 +1,116 @@
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+
+#include "game.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 小端字节写入 (存档块的内容)，与机器字节序和结构体对齐无关
+class ByteWriter {
+public:
+    void writeU8(unsigned char value) { bytes.push_back(value); }
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+    void writeInt(int value) { writeU32(static_cast<uint32_t>(value)); }
+    void writeFloat(float value);
+
+    const std::vector<unsigned char>& data() const { return bytes; }
+    std::vector<unsigned char>& data() { return bytes; }
+
+private:
+    std::vector<unsigned char> bytes;
+};
+
+// 按顺序读取小端数据，读到末尾之后的所有读取都返回 false
+class ByteReader {
+public:
+    explicit ByteReader(const std::vector<unsigned char>& bytes) : bytes(bytes), pos(0) {}
+
+    bool readU8(unsigned char& value);
+    bool readU32(uint32_t& value);
+    bool readU64(uint64_t& value);
+    bool readInt(int& value);
+    bool readFloat(float& value);
+
+    bool atEnd() const { return pos == bytes.size(); }
+
+private:
+    const std::vector<unsigned char>& bytes;
+    size_t pos;
+};
+
+// 块的种类 (文件里按四个字符存)
+constexpr uint32_t makeChunkId(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(a)) |
+        static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8 |
+        static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16 |
+        static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24;
+}
+
+const uint32_t CHUNK_META = makeChunkId('M', 'E', 'T', 'A');      // 角色、关卡、分数、状态、帧数、种子
+const uint32_t CHUNK_PLAYER = makeChunkId('P', 'L', 'Y', 'R');    // 玩家位置、生命、无敌和冷却、横扫状态
+const uint32_t CHUNK_OBSTACLES = makeChunkId('O', 'S', 'E', 'D');  // 障碍物区块的种子 (区块读档后按需重新生成)
+const uint32_t CHUNK_MONSTERS = makeChunkId('M', 'O', 'N', 'S');  // 每只怪物的位置、种类、传送和射击计时
+const uint32_t CHUNK_BULLETS = makeChunkId('B', 'U', 'L', 'L');
+const uint32_t CHUNK_RNG = makeChunkId('R', 'N', 'G', ' ');       // 三个随机数流的状态
+const uint32_t CHUNK_MONSTER_AI = makeChunkId('M', 'O', 'A', 'I'); // 每只怪物决策时选定的路点 (可以没有，读档后从下次决策开始重新选)
+const uint32_t CHUNK_GROUP = makeChunkId('G', 'R', 'U', 'P');    // 一次追加写入的所有块 (内容是完整的块序列，整组一起生效)
+
+struct SaveChunk {
+    uint32_t id;
+    std::vector<unsigned char> data;
+};
+
+// 世界快照：每类状态一个块，同一种块只保留一份
+struct WorldSnapshot {
+    std::vector<SaveChunk> chunks;
+
+    const SaveChunk* find(uint32_t id) const;
+    // 替换同种类的块，没有则添加
+    void set(uint32_t id, const std::vector<unsigned char>& data);
+    void clear() { chunks.clear(); }
+};
+
+// 存档槽的摘要 (存档选择界面显示用)
+struct SaveSummary {
+    bool exists = false;
+    bool legacy = false;    // 旧格式存档：只有角色、生命、关卡和分数，读档时重新生成关卡
+    int playerType = 0;     // 0: 近战, 1: 远程
+    int health = PLAYER_MAX_HEALTH;
+    int level = 1;
+    int score = 0;
+};
+
+// 从快照的 META 块读出摘要 (不设置 exists)
+bool readSnapshotSummary(const WorldSnapshot& snapshot, SaveSummary& summary);
+
+// 读取存档文件。新格式依次读出所有块，同一种块以后面追加的为准，末尾写坏的块被忽略
+// (追加写入的块组只在整组完整时生效，不会出现一部分块新、一部分块旧的局面)；
+// 旧格式 (直接写入的 GameSave 结构体) 只填写摘要，snapshot 为空
+bool readSaveFile(const std::string& path, WorldSnapshot& snapshot, SaveSummary& summary);
+
+// 完整写入：先写临时文件再改名，写到一半退出也不会损坏原来的存档
+bool writeSaveFile(const std::string& path, const WorldSnapshot& snapshot);
+
+// 自动存档：记住每个块上次写入的哈希，之后只把变化了的块打包成一个块组追加到文件末尾。
+// 第一次写入、或追加的总量超过一份完整存档时改为完整写入 (顺便压缩掉旧的块)
+class SaveWriter {
+public:
+    // 换一个存档文件，下一次写入一定是完整写入
+    void open(const std::string& filePath);
+    bool isOpen() const { return !path.empty(); }
+
+    bool writeFull(const WorldSnapshot& snapshot);
+    bool writeDelta(const WorldSnapshot& snapshot);
+
+private:
+    std::string path;
+    std::vector<std::pair<uint32_t, uint32_t>> writtenHashes;   // 块种类 -> 文件里最新一份的哈希
+    size_t fullSize = 0;        // 上次完整写入的字节数
+    size_t appendedSize = 0;    // 之后追加的字节数
+
+    void rememberHashes(const WorldSnapshot& snapshot);
+};
+
+#endif // SAVEFILE_H
@@ -0,0 +1,147 @@
+#include "saveservice.h"
+#include "profiler.h"
+#include <cstdio>
+#include <sstream>
+#include <utility>
+
+SaveService::SaveService() : pending(0), stopping(false) {
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        writers[i].open(slotPath(i));
+    }
+    worker = std::thread(&SaveService::run, this);
+    submit(Request{ SCAN_SLOTS, -1, WorldSnapshot(), SaveCallback(), LoadCallback() });
+}
+
+SaveService::~SaveService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+std::string SaveService::slotPath(int slot) {
+    std::stringstream ss;
+    ss << "save" << slot + 1 << ".dat";
+    return ss.str();
+}
+
+void SaveService::save(int slot, WorldSnapshot snapshot, bool delta, SaveCallback callback) {
+    submit(Request{ delta ? SAVE_DELTA : SAVE_FULL, slot, std::move(snapshot), std::move(callback), LoadCallback() });
+}
+
+void SaveService::load(int slot, LoadCallback callback) {
+    submit(Request{ LOAD_SLOT, slot, WorldSnapshot(), SaveCallback(), std::move(callback) });
+}
+
+void SaveService::remove(int slot, SaveCallback callback) {
+    submit(Request{ REMOVE_SLOT, slot, WorldSnapshot(), std::move(callback), LoadCallback() });
+}
+
+void SaveService::pollCompleted() {
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.swap(completed);
+    }
+    // 回调可能提交新的请求，所以在锁外执行
+    for (Completion& completion : done) {
+        if (completion.saveCallback) {
+            completion.saveCallback(completion.ok);
+        }
+        if (completion.loadCallback) {
+            completion.loadCallback(completion.ok, completion.snapshot, completion.summary);
+        }
+    }
+    if (!done.empty()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending -= done.size();
+    }
+}
+
+SaveSummary SaveService::getSlot(int slot) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots[slot];
+}
+
+bool SaveService::isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending > 0;
+}
+
+void SaveService::submit(Request request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(std::move(request));
+        pending++;
+    }
+    wake.notify_one();
+}
+
+void SaveService::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || !requests.empty(); });
+        if (requests.empty()) {
+            return;  // stopping 且队列已空
+        }
+        Request request = std::move(requests.front());
+        requests.pop_front();
+
+        lock.unlock();
+        process(request);
+        lock.lock();
+    }
+}
+
+// 在工作线程执行一个请求，然后把回调放进完成队列
+void SaveService::process(Request& request) {
+    PROFILE_ZONE("save io");
+    Completion completion;
+    completion.saveCallback = std::move(request.saveCallback);
+    completion.loadCallback = std::move(request.loadCallback);
+    completion.ok = true;
+
+    int slot = request.slot;
+    SaveSummary summary;
+    bool slotChanged = false;
+
+    switch (request.type) {
+    case SCAN_SLOTS: {
+        SaveSummary scanned[SLOT_COUNT];
+        WorldSnapshot snapshot;
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            readSaveFile(slotPath(i), snapshot, scanned[i]);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            slots[i] = scanned[i];
+        }
+        break;
+    }
+    case SAVE_FULL:
+    case SAVE_DELTA:
+        completion.ok = request.type == SAVE_FULL ? writers[slot].writeFull(request.snapshot)
+            : writers[slot].writeDelta(request.snapshot);
+        if (completion.ok && readSnapshotSummary(request.snapshot, summary)) {
+            summary.exists = true;
+            slotChanged = true;
+        }
+        break;
+    case LOAD_SLOT:
+        completion.ok = readSaveFile(slotPath(slot), completion.snapshot, completion.summary);
+        break;
+    case REMOVE_SLOT:
+        completion.ok = std::remove(slotPath(slot).c_str()) == 0;
+        writers[slot].open(slotPath(slot));
+        slotChanged = true;
+        break;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slotChanged) {
+        slots[slot] = summary;
+    }
+    completed.push_back(std::move(completion));
+}
@@ -0,0 +1,86 @@
+#ifndef SAVESERVICE_H
+#define SAVESERVICE_H
+
+#include "savefile.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 后台存档服务：快照在游戏线程生成，文件读写 (包括等待写入磁盘) 都在工作线程里按请求顺序执行，
+// 游戏线程不会因为磁盘慢而卡住。完成回调由 pollCompleted 在游戏线程调用。
+// 存档选择界面直接读摘要缓存，工作线程启动时扫描一次，之后每次保存或删除后更新
+class SaveService {
+public:
+    static const int SLOT_COUNT = 3;
+
+    typedef std::function<void(bool ok)> SaveCallback;
+    typedef std::function<void(bool ok, const WorldSnapshot& snapshot, const SaveSummary& summary)> LoadCallback;
+
+    SaveService();
+    // 执行完队列里剩下的请求再退出 (退出游戏时不会丢掉最后一次保存)
+    ~SaveService();
+
+    SaveService(const SaveService&) = delete;
+    SaveService& operator=(const SaveService&) = delete;
+
+    // 完整保存；delta 为 true 时是自动存档，只追加有变化的块
+    void save(int slot, WorldSnapshot snapshot, bool delta, SaveCallback callback = SaveCallback());
+    // 读取存档 (新格式得到快照，旧格式只有摘要)
+    void load(int slot, LoadCallback callback);
+    void remove(int slot, SaveCallback callback = SaveCallback());
+
+    // 在游戏线程每帧调用，执行已完成请求的回调
+    void pollCompleted();
+
+    // 存档槽摘要缓存 (还没扫描完时为空)
+    SaveSummary getSlot(int slot) const;
+    // 还有请求没有完成 (包括回调还没被调用)
+    bool isBusy() const;
+
+    static std::string slotPath(int slot);
+
+private:
+    enum RequestType {
+        SCAN_SLOTS,
+        SAVE_FULL,
+        SAVE_DELTA,
+        LOAD_SLOT,
+        REMOVE_SLOT
+    };
+
+    struct Request {
+        RequestType type;
+        int slot;
+        WorldSnapshot snapshot;
+        SaveCallback saveCallback;
+        LoadCallback loadCallback;
+    };
+
+    struct Completion {
+        SaveCallback saveCallback;
+        LoadCallback loadCallback;
+        bool ok;
+        WorldSnapshot snapshot;
+        SaveSummary summary;
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Request> requests;
+    std::vector<Completion> completed;
+    size_t pending;                      // 已提交但回调还没执行的请求数
+    bool stopping;
+    SaveSummary slots[SLOT_COUNT];
+    SaveWriter writers[SLOT_COUNT];      // 只在工作线程使用
+    std::thread worker;
+
+    void submit(Request request);
+    void run();
+    void process(Request& request);
+};
+
+#endif // SAVESERVICE_H
@@ -0,0 +1,191 @@
+#include "simthread.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+
+static sf::Vector2f lerp(const sf::Vector2f& from, const sf::Vector2f& to, float alpha) {
+    return from + (to - from) * alpha;
+}
+
+// 插值的起点：没有正好推进一帧，或者一帧内移动太远 (传送、下标被别的怪物占用) 时不插值
+static sf::Vector2f interpolationStart(const sf::Vector2f& previous, const sf::Vector2f& current, bool stepped) {
+    if (!stepped) {
+        return current;
+    }
+    const float maxDistance = SimThread::MAX_INTERPOLATE_DISTANCE;
+    sf::Vector2f d = current - previous;
+    return d.x * d.x + d.y * d.y <= maxDistance * maxDistance ? previous : current;
+}
+
+sf::Vector2f RenderSnapshot::getPlayerPosition(float alpha) const {
+    return lerp(playerPrevious, playerCurrent, alpha);
+}
+
+void RenderSnapshot::appendEntities(ShapeBatch& batch, float alpha) const {
+    for (const Body& monster : monsters) {
+        batch.addRect(sf::FloatRect(lerp(monster.previous, monster.current, alpha), monster.size), monster.color);
+    }
+    for (const Body& bullet : bullets) {
+        batch.addRect(sf::FloatRect(lerp(bullet.previous, bullet.current, alpha), bullet.size), bullet.color);
+    }
+}
+
+float RenderSnapshot::getInterpolation(Clock::time_point now) const {
+    float alpha = std::chrono::duration<float>(now - time).count() / World::TICK_SECONDS;
+    return std::max(0.f, std::min(alpha, 1.f));
+}
+
+SimThread::SimThread(World& world, TickFunction tickFunction)
+    : world(world), tickFunction(std::move(tickFunction)), stopping(false), active(false),
+      writeIndex(0), readyIndex(1), readIndex(2), fresh(false), lastTick(0), hasLast(false) {
+    thread = std::thread(&SimThread::run, this);
+}
+
+SimThread::~SimThread() {
+    {
+        std::lock_guard<std::mutex> lock(worldMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void SimThread::setActive(bool on) {
+    active = on;
+}
+
+void SimThread::setMovement(bool left, bool right, bool up, bool down) {
+    input.left = left;
+    input.right = right;
+    input.up = up;
+    input.down = down;
+}
+
+void SimThread::queueAttack(const sf::Vector2f& target) {
+    input.attack = true;
+    input.target = target;
+}
+
+const RenderSnapshot& SimThread::acquireSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (fresh) {
+        std::swap(readIndex, readyIndex);
+        fresh = false;
+    }
+    return snapshots[readIndex];
+}
+
+void SimThread::run() {
+    const Clock::duration tickDuration =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(World::TICK_SECONDS));
+    const Clock::duration maxLag = tickDuration * static_cast<int>(MAX_CATCH_UP_TICKS);
+    Clock::time_point next = Clock::now();
+
+    std::unique_lock<std::mutex> lock(worldMutex);
+    while (true) {
+        // 等待时放开世界锁，主线程在这时处理输入和读写存档
+        wake.wait_until(lock, next, [this]() { return stopping; });
+        if (stopping) {
+            return;
+        }
+        Clock::time_point now = Clock::now();
+        if (now < next) {
+            continue;
+        }
+        // 卡顿时最多追赶几帧，避免越落越多
+        if (now - next > maxLag) {
+            next = now - maxLag;
+        }
+
+        if (active) {
+            PROFILE_ZONE("simulation");
+            tickFunction(input);
+        }
+        input.attack = false;   // 点击只在一个逻辑帧内生效 (暂停时的点击直接丢掉)
+
+        capture(snapshots[writeIndex], next);
+        publish();
+        next += tickDuration;
+    }
+}
+
+void SimThread::capture(RenderSnapshot& snapshot, Clock::time_point time) {
+    PROFILE_ZONE("capture");
+    snapshot.status = world.getStatus();
+    snapshot.tick = world.getTick();
+    snapshot.time = time;
+    snapshot.background.clear();
+    snapshot.effects.clear();
+    snapshot.monsters.clear();
+    snapshot.bullets.clear();
+    if (!world.hasPlayer()) {
+        hasLast = false;
+        return;
+    }
+
+    // 只有正好推进了一个逻辑帧才插值 (暂停、读档时直接画当前位置)
+    const bool stepped = hasLast && snapshot.tick == lastTick + 1;
+    const Player& player = world.getPlayer();
+    snapshot.playerType = world.getPlayerType();
+    snapshot.health = player.getHealth();
+    snapshot.score = world.getScore();
+    snapshot.level = world.getLevel();
+    snapshot.playerCurrent = player.getPosition();
+    snapshot.playerPrevious = interpolationStart(lastPlayerPosition, snapshot.playerCurrent, stepped);
+    snapshot.playerSize = sf::Vector2f(player.getBounds().width, player.getBounds().height);
+
+    // 摄像机视野加上一圈余量
+    const float margin = CAPTURE_MARGIN;
+    sf::Vector2f center = cameraCenter(player.getCenter());
+    sf::FloatRect area(center.x - WINDOW_WIDTH / 2.f - margin, center.y - WINDOW_HEIGHT / 2.f - margin,
+        WINDOW_WIDTH + 2.f * margin, WINDOW_HEIGHT + 2.f * margin);
+
+    world.getObstacles().appendTo(snapshot.background, area);
+
+    // 怪物按下标对应上一帧的位置，删除怪物时下标会变，移动距离不合理的不插值
+    const MonsterStore& monsters = world.getMonsters();
+    for (size_t i = 0; i < monsters.size(); ++i) {
+        if (!monsters.getBounds(i).intersects(area)) {
+            continue;
+        }
+        RenderSnapshot::Body body;
+        body.current = monsters.getPosition(i);
+        body.previous = i < lastMonsterPositions.size() ? interpolationStart(lastMonsterPositions[i], body.current, stepped) : body.current;
+        body.size = sf::Vector2f(monsters.w[i], monsters.h[i]);
+        body.color = monsterKindColors[monsters.kind[i]];
+        snapshot.monsters.push_back(body);
+    }
+    lastMonsterPositions.resize(monsters.size());
+    for (size_t i = 0; i < monsters.size(); ++i) {
+        lastMonsterPositions[i] = monsters.getPosition(i);
+    }
+
+    // 子弹匀速直线飞行，上一帧的位置就是减去一帧的速度
+    for (const auto& bullet : world.getBullets()) {
+        sf::FloatRect bounds = bullet.getBounds();
+        if (!bounds.intersects(area)) {
+            continue;
+        }
+        RenderSnapshot::Body body;
+        body.current = sf::Vector2f(bounds.left, bounds.top);
+        body.previous = stepped ? body.current - bullet.getVelocity() : body.current;
+        body.size = sf::Vector2f(bounds.width, bounds.height);
+        body.color = bullet.getColor();
+        snapshot.bullets.push_back(body);
+    }
+
+    if (const MeleePlayer* meleePlayer = dynamic_cast<const MeleePlayer*>(&player)) {
+        meleePlayer->appendSweepEffect(snapshot.effects);
+    }
+    world.getParticles().appendTo(snapshot.effects, area);
+
+    lastTick = snapshot.tick;
+    lastPlayerPosition = snapshot.playerCurrent;
+    hasLast = true;
+}
+
+void SimThread::publish() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    std::swap(writeIndex, readyIndex);
+    fresh = true;
+}
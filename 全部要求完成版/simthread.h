@@ -0,0 +1,112 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include "world.h"
+#include "render.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 绘制用的世界快照：模拟线程每个逻辑帧结束后生成，绘制时只读快照，不访问 World。
+// 只包含摄像机附近的东西；会移动的矩形同时记下上一逻辑帧的位置，绘制时按两帧之间的比例插值
+struct RenderSnapshot {
+    typedef std::chrono::steady_clock Clock;
+
+    // 插值绘制的矩形 (怪物、子弹)
+    struct Body {
+        sf::Vector2f previous;   // 上一逻辑帧的左上角
+        sf::Vector2f current;
+        sf::Vector2f size;
+        sf::Color color;
+    };
+
+    WorldStatus status = WorldStatus::IDLE;
+    unsigned long long tick = 0;
+    Clock::time_point time;      // 这个逻辑帧按计划执行的时间
+    int playerType = 0;
+    int health = 0;
+    int score = 0;
+    int level = 0;
+    sf::Vector2f playerPrevious;
+    sf::Vector2f playerCurrent;
+    sf::Vector2f playerSize;
+    ShapeBatch background;       // 障碍物 (不移动)
+    ShapeBatch effects;          // 粒子和横扫特效 (不插值)
+    std::vector<Body> monsters;
+    std::vector<Body> bullets;
+
+    // alpha 为距离本逻辑帧过去的时间占一帧的比例 [0, 1]
+    sf::Vector2f getPlayerPosition(float alpha) const;
+    sf::Vector2f getPlayerCenter(float alpha) const { return getPlayerPosition(alpha) + playerSize / 2.f; }
+    // 画在玩家贴图上面的怪物、子弹和特效
+    void appendEntities(ShapeBatch& batch, float alpha) const;
+    // 现在应该使用的插值比例
+    float getInterpolation(Clock::time_point now) const;
+};
+
+// 模拟线程：按 World::TICK_SECONDS 的固定步长推进世界，与绘制帧率无关 (绘制慢时逻辑帧不会变慢)。
+// 快照有三份缓冲：模拟线程写一份，绘制线程读一份，中间一份是最新发布的，两边都不用等对方。
+// 主线程访问世界 (开始、读档、存档、查询状态) 前必须锁住 getWorldMutex()，
+// 模拟线程只在执行一个逻辑帧和生成快照时持有它
+class SimThread {
+public:
+    typedef RenderSnapshot::Clock Clock;
+    // 在模拟线程执行一个逻辑帧 (持有世界锁)，input 是主线程最近设置的按键和排队的点击
+    typedef std::function<void(const InputFrame& input)> TickFunction;
+
+    static const int MAX_CATCH_UP_TICKS = 5;        // 落后太多时最多追赶的逻辑帧数，其余的丢掉
+    static constexpr float CAPTURE_MARGIN = 64.f;   // 快照在视野外多保留的范围 (插值和摄像机移动用)
+    static constexpr float MAX_INTERPOLATE_DISTANCE = 16.f;   // 一帧内移动超过这个距离 (传送、换关) 时不插值
+
+    SimThread(World& world, TickFunction tickFunction);
+    ~SimThread();
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    std::mutex& getWorldMutex() { return worldMutex; }
+
+    // 以下三个函数需要持有世界锁
+    // 是否推进逻辑帧 (存档选择、角色选择和暂停时为 false，快照仍然每帧更新)
+    void setActive(bool on);
+    // 移动按键的状态
+    void setMovement(bool left, bool right, bool up, bool down);
+    // 点击攻击，在下一个逻辑帧执行
+    void queueAttack(const sf::Vector2f& target);
+
+    // 取最新发布的快照，返回的引用在下一次调用前有效 (只能在一个线程里调用)
+    const RenderSnapshot& acquireSnapshot();
+
+private:
+    World& world;
+    TickFunction tickFunction;
+    std::mutex worldMutex;
+    std::condition_variable wake;
+    bool stopping;
+    bool active;
+    InputFrame input;
+
+    RenderSnapshot snapshots[3];
+    std::mutex snapshotMutex;        // 只保护三个下标的交换
+    int writeIndex;
+    int readyIndex;
+    int readIndex;
+    bool fresh;                      // 中间一份是绘制线程还没取走的新快照
+
+    // 上一份快照时世界的状态 (只在模拟线程使用)，用于插值的起点
+    unsigned long long lastTick;
+    bool hasLast;
+    sf::Vector2f lastPlayerPosition;
+    std::vector<sf::Vector2f> lastMonsterPositions;
+
+    std::thread thread;
+
+    void run();
+    void capture(RenderSnapshot& snapshot, Clock::time_point time);
+    void publish();
+};
+
+#endif // SIMTHREAD_H
@@ -0,0 +1,510 @@
+#include "world.h"
+#include "savefile.h"
+#include "profiler.h"
+#include "jobs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// FNV-1a 哈希
+static void hashBytes(uint32_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+}
+
+static void hashFloat(uint32_t& hash, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    hashBytes(hash, &bits, sizeof(bits));
+}
+
+// 摄像机中心夹在地图内
+sf::Vector2f cameraCenter(const sf::Vector2f& playerCenter) {
+    const float halfWidth = WINDOW_WIDTH / 2.f;
+    const float halfHeight = WINDOW_HEIGHT / 2.f;
+    sf::Vector2f center = playerCenter;
+    center.x = std::max(halfWidth, std::min(center.x, MAP_WIDTH - halfWidth));
+    center.y = std::max(halfHeight, std::min(center.y, MAP_HEIGHT - halfHeight));
+    return center;
+}
+
+World::World()
+    : player(nullptr), playerType(0), particles(PARTICLE_CAPACITY), score(0), currentLevel(1), status(WorldStatus::IDLE),
+    sweepDamageApplied(false), tick(0), seed(0) {
+}
+
+World::~World() {
+    delete player;
+}
+
+void World::start(int type, int level, int startScore, int health, uint64_t runSeed) {
+    reset();
+    seed = runSeed;
+    levelRng.reseed(Rng::deriveSeed(seed, 1));
+    aiRng.reseed(Rng::deriveSeed(seed, 2));
+    effectsRng.reseed(Rng::deriveSeed(seed, 3));
+
+    playerType = type;
+    if (playerType == 0) {
+        player = new MeleePlayer();
+    }
+    else {
+        player = new RangedPlayer();
+    }
+    player->setHealth(health);
+    currentLevel = level;
+    score = startScore;
+    loadLevel();
+}
+
+void World::reset() {
+    delete player;
+    player = nullptr;
+    monsters.clear();
+    bullets.clear();
+    particles.clear();
+    obstacles.clear();
+    score = 0;
+    currentLevel = 1;
+    status = WorldStatus::IDLE;
+    sweepDamageApplied = false;
+    tick = 0;
+}
+
+void World::nextLevel() {
+    player->reset();
+    score = 0;
+
+    if (currentLevel < MAX_LEVEL) {
+        currentLevel++;
+    }
+    loadLevel();
+}
+
+// 生成当前关卡的障碍物和怪物
+void World::loadLevel() {
+    monsters.clear();
+    bullets.clear();
+    particles.clear();
+    sweepDamageApplied = false;
+
+    // 障碍物区块按需生成，这里只决定本关的区块种子 (两次调用分开写，保证求值顺序)
+    uint64_t obstacleSeed = static_cast<uint64_t>(levelRng.next()) << 32;
+    obstacleSeed |= levelRng.next();
+    obstacles.reset(currentLevel, obstacleSeed);
+    streamChunks();
+    monsters.spawnWave(currentLevel + 1, obstacles, nearArea, levelRng);
+    status = WorldStatus::RUNNING;
+}
+
+// 玩家换了区块：加载附近的区块、卸载远处的区块，流场跟着移到新的中心
+void World::streamChunks() {
+    if (!obstacles.streamAround(player->getCenter())) {
+        return;
+    }
+    nearArea = obstacles.getChunkArea(NEAR_CHUNK_RADIUS);
+    activeArea = obstacles.getChunkArea(ObstacleGrid::ACTIVE_RADIUS);
+    flowField.build(obstacles, nearArea);
+}
+
+// 怪物每帧更新的范围：玩家附近的区块加上摄像机视野 (外扩 FULL_RATE_MARGIN)，屏幕上的怪物不会降频
+sf::FloatRect World::getFullRateArea() const {
+    const float margin = FULL_RATE_MARGIN;
+    const sf::Vector2f center = cameraCenter(player->getCenter());
+    const float left = std::min(nearArea.left, center.x - WINDOW_WIDTH / 2.f - margin);
+    const float top = std::min(nearArea.top, center.y - WINDOW_HEIGHT / 2.f - margin);
+    const float right = std::max(nearArea.left + nearArea.width, center.x + WINDOW_WIDTH / 2.f + margin);
+    const float bottom = std::max(nearArea.top + nearArea.height, center.y + WINDOW_HEIGHT / 2.f + margin);
+    return sf::FloatRect(left, top, right - left, bottom - top);
+}
+
+void World::step(const InputFrame& input) {
+    if (status != WorldStatus::RUNNING) {
+        return;
+    }
+    tick++;
+
+    {
+        PROFILE_ZONE("player");
+        if (input.attack) {
+            handleAttack(input.target);
+        }
+
+        // 玩家移动
+        if (input.left)
+            player->move(-5, 0, obstacles);
+        if (input.right)
+            player->move(5, 0, obstacles);
+        if (input.up)
+            player->move(0, -5, obstacles);
+        if (input.down)
+            player->move(0, 5, obstacles);
+
+        player->updateInvincibility();
+        player->updateShootCooldown();
+        streamChunks();
+    }
+
+    {
+        PROFILE_ZONE("sweep");
+        updateSweep();
+    }
+    {
+        PROFILE_ZONE("effects");
+        updateEffects();
+    }
+
+    {
+        // 怪物移动 (玩家换了格子才重新计算流场)
+        PROFILE_ZONE("monsters");
+        flowField.setTarget(player->getCenter());
+        monsters.update(player->getPosition(), flowField, particles, bullets, obstacles, getFullRateArea(), activeArea, tick, aiRng.next());
+    }
+
+    {
+        PROFILE_ZONE("bullets");
+        updateBullets();
+    }
+    {
+        PROFILE_ZONE("contact");
+        checkContactDamage();
+        checkStatus();
+    }
+}
+
+// 点击攻击：近战玩家横扫，远程玩家向点击位置射击
+void World::handleAttack(const sf::Vector2f& target) {
+    if (!player->canShoot()) {
+        return;
+    }
+    if (MeleePlayer* melee = dynamic_cast<MeleePlayer*>(player)) {
+        melee->startSweep();
+    }
+    else if (RangedPlayer* ranged = dynamic_cast<RangedPlayer*>(player)) {
+        bullets.emplace_back(player->getCenter(), target, true, ranged->getBulletSpeed());
+    }
+    player->setShootCooldown();
+}
+
+// 横扫动画与范围伤害
+void World::updateSweep() {
+    MeleePlayer* melee = dynamic_cast<MeleePlayer*>(player);
+    if (!melee) {
+        return;
+    }
+
+    melee->updateSweep(particles, effectsRng);
+    if (melee->isSweeping()) {
+        float sweepRadius = melee->getAttackRange();
+        float sweepAngle = melee->getSweepAngle();
+        sf::Vector2f center = melee->getCenter();
+        if (!sweepDamageApplied && sweepAngle > 180.f) {
+            for (size_t i = monsters.size(); i-- > 0;) {
+                sf::Vector2f mCenter = monsters.getCenter(i);
+                float dist = std::hypot(center.x - mCenter.x, center.y - mCenter.y);
+                if (dist <= sweepRadius) {
+                    emitDeathEffect(particles, mCenter, monsterKindColors[monsters.kind[i]], effectsRng);
+                    monsters.removeSwap(i);
+                    score++;
+                }
+            }
+            sweepDamageApplied = true;
+        }
+    }
+    else {
+        sweepDamageApplied = false;
+    }
+}
+
+// 更新所有特效粒子
+void World::updateEffects() {
+    particles.update();
+}
+
+// 子弹移动和碰撞检测：子弹之间互不影响，先分块并行移动，
+// 再从后往前逐个检查命中并就地交换移除，被击中的怪物先标记，最后批量移除
+void World::updateBullets() {
+    monsterGrid.rebuild(monsters, activeArea);
+    sf::FloatRect playerBounds = player->getBounds();
+
+    bulletBlocked.resize(bullets.size());
+    JobSystem::instance().parallelFor(bullets.size(), BULLET_GRAIN, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            bulletBlocked[i] = !bullets[i].move(obstacles);
+        }
+    });
+
+    // 换到 i 的子弹都来自更后面，bulletBlocked[i] 总是对应原来的第 i 颗
+    for (size_t i = bullets.size(); i-- > 0;) {
+        Bullet& bullet = bullets[i];
+        bool spent = bulletBlocked[i] != 0;
+
+        if (!spent) {
+            sf::FloatRect bounds = bullet.getBounds();
+            if (bullet.isFromPlayer()) {
+                // 玩家子弹击中怪物
+                int id = monsterGrid.findFirstHit(bounds);
+                if (id >= 0) {
+                    emitDeathEffect(particles, monsters.getCenter(id), monsterKindColors[monsters.kind[id]], effectsRng);
+                    monsterGrid.markHit(id);
+                    score++;
+                    spent = true;
+                }
+            }
+            // 怪物子弹击中玩家
+            else if (playerBounds.intersects(bounds)) {
+                player->reduceHealth();
+                spent = true;
+            }
+
+            // 出界或飞出参与碰撞的区块
+            if (!activeArea.contains(bounds.left, bounds.top)) {
+                spent = true;
+            }
+        }
+
+        if (spent) {
+            bullets[i] = bullets.back();
+            bullets.pop_back();
+        }
+    }
+
+    // 从后往前交换移除，换过来的怪物都已检查过
+    for (size_t i = monsters.size(); i-- > 0;) {
+        if (monsterGrid.isHit(i)) {
+            monsters.removeSwap(i);
+        }
+    }
+}
+
+// 检查玩家与怪物的碰撞
+void World::checkContactDamage() {
+    sf::FloatRect playerBounds = player->getBounds();
+    for (size_t i = 0; i < monsters.size(); ++i) {
+        if (playerBounds.intersects(monsters.getBounds(i))) {
+            player->reduceHealth();
+        }
+    }
+}
+
+// 检查游戏状态
+void World::checkStatus() {
+    if (player->getHealth() <= 0) {
+        status = WorldStatus::GAME_OVER;
+    }
+    else if (score >= 3) {  // 每关需要击杀3只怪物
+        score = 0;  // 重置当前关卡的分数
+        if (currentLevel >= MAX_LEVEL) {
+            status = WorldStatus::VICTORY; // 第三关完成，游戏胜利
+        }
+        else {
+            status = WorldStatus::LEVEL_COMPLETE; // 还有下一关
+        }
+    }
+}
+
+uint32_t World::stateHash() const {
+    uint32_t hash = 2166136261u;
+    hashBytes(hash, &tick, sizeof(tick));
+    hashBytes(hash, &score, sizeof(score));
+    hashBytes(hash, &currentLevel, sizeof(currentLevel));
+    if (player) {
+        int health = player->getHealth();
+        hashBytes(hash, &health, sizeof(health));
+        hashFloat(hash, player->getPosition().x);
+        hashFloat(hash, player->getPosition().y);
+    }
+
+    for (size_t i = 0; i < monsters.size(); ++i) {
+        hashFloat(hash, monsters.x[i]);
+        hashFloat(hash, monsters.y[i]);
+        hashBytes(hash, &monsters.kind[i], sizeof(monsters.kind[i]));
+        hashBytes(hash, &monsters.timer[i], sizeof(monsters.timer[i]));
+        hashBytes(hash, &monsters.flags[i], sizeof(monsters.flags[i]));
+        hashFloat(hash, monsters.goalX[i]);
+        hashFloat(hash, monsters.goalY[i]);
+    }
+
+    for (const auto& bullet : bullets) {
+        sf::FloatRect bounds = bullet.getBounds();
+        hashFloat(hash, bounds.left);
+        hashFloat(hash, bounds.top);
+    }
+    return hash;
+}
+
+static void writeRng(ByteWriter& writer, const Rng& rng) {
+    uint32_t state[4];
+    rng.getState(state);
+    for (int i = 0; i < 4; ++i) {
+        writer.writeU32(state[i]);
+    }
+}
+
+static bool readRng(ByteReader& reader, Rng& rng) {
+    uint32_t state[4];
+    for (int i = 0; i < 4; ++i) {
+        if (!reader.readU32(state[i])) {
+            return false;
+        }
+    }
+    rng.setState(state);
+    return true;
+}
+
+void World::writeSnapshot(WorldSnapshot& snapshot) const {
+    snapshot.clear();
+    if (!player) {
+        return;
+    }
+
+    // 前四项同时是存档选择界面的摘要
+    ByteWriter meta;
+    meta.writeInt(playerType);
+    meta.writeInt(currentLevel);
+    meta.writeInt(score);
+    meta.writeInt(player->getHealth());
+    meta.writeInt(static_cast<int>(status));
+    meta.writeU64(tick);
+    meta.writeU64(seed);
+    meta.writeU8(sweepDamageApplied ? 1 : 0);
+    snapshot.set(CHUNK_META, meta.data());
+
+    ByteWriter playerState;
+    player->writeState(playerState);
+    snapshot.set(CHUNK_PLAYER, playerState.data());
+
+    ByteWriter obstacleState;
+    obstacleState.writeU64(obstacles.getSeed());
+    snapshot.set(CHUNK_OBSTACLES, obstacleState.data());
+
+    ByteWriter monsterState;
+    monsterState.writeU32(static_cast<uint32_t>(monsters.size()));
+    for (size_t i = 0; i < monsters.size(); ++i) {
+        monsterState.writeU8(monsters.kind[i]);
+        monsterState.writeFloat(monsters.x[i]);
+        monsterState.writeFloat(monsters.y[i]);
+        monsterState.writeInt(monsters.timer[i]);
+        monsterState.writeInt(monsters.cooldown[i]);
+        monsterState.writeU8(monsters.flags[i]);
+    }
+    snapshot.set(CHUNK_MONSTERS, monsterState.data());
+
+    ByteWriter monsterAi;
+    for (size_t i = 0; i < monsters.size(); ++i) {
+        monsterAi.writeFloat(monsters.goalX[i]);
+        monsterAi.writeFloat(monsters.goalY[i]);
+    }
+    snapshot.set(CHUNK_MONSTER_AI, monsterAi.data());
+
+    ByteWriter bulletState;
+    bulletState.writeU32(static_cast<uint32_t>(bullets.size()));
+    for (const auto& bullet : bullets) {
+        bullet.writeState(bulletState);
+    }
+    snapshot.set(CHUNK_BULLETS, bulletState.data());
+
+    ByteWriter rngState;
+    writeRng(rngState, levelRng);
+    writeRng(rngState, aiRng);
+    writeRng(rngState, effectsRng);
+    snapshot.set(CHUNK_RNG, rngState.data());
+}
+
+bool World::readSnapshot(const WorldSnapshot& snapshot) {
+    reset();
+    const SaveChunk* chunks[6] = {
+        snapshot.find(CHUNK_META), snapshot.find(CHUNK_PLAYER), snapshot.find(CHUNK_OBSTACLES),
+        snapshot.find(CHUNK_MONSTERS), snapshot.find(CHUNK_BULLETS), snapshot.find(CHUNK_RNG)
+    };
+    for (const SaveChunk* chunk : chunks) {
+        if (!chunk) {
+            return false;
+        }
+    }
+
+    bool ok = true;
+    int health, statusValue;
+    uint64_t savedTick;
+    unsigned char damageApplied;
+    ByteReader meta(chunks[0]->data);
+    ok = meta.readInt(playerType) && meta.readInt(currentLevel) && meta.readInt(score) && meta.readInt(health) &&
+        meta.readInt(statusValue) && meta.readU64(savedTick) && meta.readU64(seed) && meta.readU8(damageApplied);
+    ok = ok && statusValue > static_cast<int>(WorldStatus::IDLE) && statusValue <= static_cast<int>(WorldStatus::GAME_OVER);
+    status = static_cast<WorldStatus>(statusValue);
+    tick = savedTick;
+    sweepDamageApplied = damageApplied != 0;
+
+    if (playerType == 0) {
+        player = new MeleePlayer();
+    }
+    else {
+        player = new RangedPlayer();
+    }
+    ByteReader playerState(chunks[1]->data);
+    ok = ok && player->readState(playerState);
+
+    // 按玩家位置重新生成附近的区块 (与存档时加载的区块相同)
+    uint64_t obstacleSeed;
+    ByteReader obstacleState(chunks[2]->data);
+    ok = ok && obstacleState.readU64(obstacleSeed);
+    if (ok) {
+        obstacles.reset(currentLevel, obstacleSeed);
+        streamChunks();
+    }
+
+    uint32_t count = 0;
+
+    ByteReader monsterState(chunks[3]->data);
+    ok = ok && monsterState.readU32(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        unsigned char kind, flags;
+        float x, y;
+        int timer, cooldown;
+        ok = monsterState.readU8(kind) && kind < MONSTER_KIND_COUNT && monsterState.readFloat(x) && monsterState.readFloat(y) &&
+            monsterState.readInt(timer) && monsterState.readInt(cooldown) && monsterState.readU8(flags);
+        if (ok) {
+            monsters.add(static_cast<MonsterKind>(kind), sf::Vector2f(x, y));
+            monsters.timer.back() = timer;
+            monsters.cooldown.back() = cooldown;
+            monsters.flags.back() = flags;
+        }
+    }
+
+    // 路点块是后来加的，没有或与怪物数量不符时清除路点，从下次决策开始重新选
+    const SaveChunk* aiChunk = snapshot.find(CHUNK_MONSTER_AI);
+    if (ok && aiChunk && aiChunk->data.size() == monsters.size() * 2 * sizeof(float)) {
+        ByteReader monsterAi(aiChunk->data);
+        for (size_t i = 0; i < monsters.size(); ++i) {
+            monsterAi.readFloat(monsters.goalX[i]);
+            monsterAi.readFloat(monsters.goalY[i]);
+        }
+    }
+    else {
+        for (size_t i = 0; i < monsters.size(); ++i) {
+            monsters.flags[i] &= ~MonsterStore::HAS_WAYPOINT;
+        }
+    }
+
+    ByteReader bulletState(chunks[4]->data);
+    ok = ok && bulletState.readU32(count);
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        Bullet bullet(sf::Vector2f(), sf::Vector2f(), false);
+        ok = bullet.readState(bulletState);
+        if (ok) {
+            bullets.push_back(bullet);
+        }
+    }
+
+    ByteReader rngState(chunks[5]->data);
+    ok = ok && readRng(rngState, levelRng) && readRng(rngState, aiRng) && readRng(rngState, effectsRng);
+
+    if (!ok) {
+        reset();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,122 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "game.h"
+#include "obstacle.h"
+#include "player.h"
+#include "bullet.h"
+#include "effects.h"
+#include "particles.h"
+#include "flowfield.h"
+#include "monster.h"
+#include "rng.h"
+#include <vector>
+
+struct WorldSnapshot;
+
+// 摄像机跟随玩家，中心夹在地图内，地图边缘不会露出外面
+sf::Vector2f cameraCenter(const sf::Vector2f& playerCenter);
+
+// 一个逻辑帧的输入 (键盘状态和本帧的点击)
+struct InputFrame {
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+    bool attack = false;      // 本帧是否点击攻击
+    sf::Vector2f target;      // 点击位置
+};
+
+// 关卡状态
+enum class WorldStatus {
+    IDLE,            // 还没有开始游戏 (选择存档或角色中)
+    RUNNING,
+    LEVEL_COMPLETE,
+    VICTORY,
+    GAME_OVER
+};
+
+// 游戏世界：所有逻辑都在这里，不依赖窗口，可以无界面地按固定步长运行
+class World {
+public:
+    static constexpr float TICK_SECONDS = 1.f / 60.f;  // 每个逻辑帧的时长
+    static const size_t PARTICLE_CAPACITY = 100000;    // 特效粒子池容量
+    static const size_t BULLET_GRAIN = 256;            // 并行移动子弹时每个任务的子弹数
+    static const int NEAR_CHUNK_RADIUS = 1;            // 玩家所在区块周围这么多圈内：流场覆盖、怪物每帧更新、出生
+    static constexpr float FULL_RATE_MARGIN = 64.f;    // 摄像机视野外扩这么多以内的怪物也每帧更新
+
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // 开始游戏 (新游戏或读档)：创建玩家，用本局种子重置所有随机数流，生成该关的障碍物和怪物
+    void start(int playerType, int level, int score, int health, uint64_t seed);
+    // 清空所有状态，回到未开始
+    void reset();
+    // 进入下一关
+    void nextLevel();
+
+    // 推进一个逻辑帧
+    void step(const InputFrame& input);
+
+    WorldStatus getStatus() const { return status; }
+    bool isRunning() const { return status == WorldStatus::RUNNING; }
+    bool hasPlayer() const { return player != nullptr; }
+    const Player& getPlayer() const { return *player; }
+    int getPlayerType() const { return playerType; }   // 0: 近战, 1: 远程
+    int getScore() const { return score; }
+    int getLevel() const { return currentLevel; }
+    unsigned long long getTick() const { return tick; }
+    uint64_t getSeed() const { return seed; }
+
+    // 逻辑状态的哈希 (玩家、怪物、子弹、分数和关卡)，用于录像重放时检测不同步
+    uint32_t stateHash() const;
+
+    // 完整快照 (存档用)：不含粒子等纯视觉状态；障碍物只存区块种子，流场读档时重新计算
+    void writeSnapshot(WorldSnapshot& snapshot) const;
+    // 从快照恢复整个世界，缺少块或块内容不完整时返回 false 并回到未开始状态
+    bool readSnapshot(const WorldSnapshot& snapshot);
+
+    const ObstacleGrid& getObstacles() const { return obstacles; }
+    const MonsterStore& getMonsters() const { return monsters; }
+    const std::vector<Bullet>& getBullets() const { return bullets; }
+    const ParticlePool& getParticles() const { return particles; }
+
+private:
+    Player* player;
+    int playerType;
+    MonsterStore monsters;
+    MonsterGrid monsterGrid;
+    std::vector<Bullet> bullets;
+    std::vector<char> bulletBlocked;   // 本帧移动时撞到障碍物的子弹
+    ParticlePool particles;    // 死亡、传送和横扫特效的粒子
+    ObstacleGrid obstacles;
+    FlowField flowField;      // 怪物追击玩家用的流场 (只覆盖 nearArea)
+    sf::FloatRect nearArea;   // 玩家附近的区块范围
+    sf::FloatRect activeArea; // 参与碰撞的区块范围，飞出去的子弹直接移除
+    int score;
+    int currentLevel;
+    WorldStatus status;
+    bool sweepDamageApplied;   // 本次横扫是否已经结算伤害
+    unsigned long long tick;
+
+    // 随机数流：都由本局种子派生，特效的随机数不会影响关卡和怪物行为
+    uint64_t seed;
+    Rng levelRng;     // 障碍物区块种子和怪物出生点
+    Rng aiRng;        // 怪物行为 (每帧取一个种子，怪物并行更新时按下标派生)
+    Rng effectsRng;   // 粒子等纯视觉效果
+
+    void loadLevel();
+    void streamChunks();
+    sf::FloatRect getFullRateArea() const;
+    void handleAttack(const sf::Vector2f& target);
+    void updateSweep();
+    void updateEffects();
+    void updateBullets();
+    void checkContactDamage();
+    void checkStatus();
+};
+
+#endif // WORLD_H